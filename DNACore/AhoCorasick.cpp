@@ -1,52 +1,103 @@
 #include "AhoCorasick.h"
+#include "ThreadPool.h"
 #include <algorithm>
+#include <iterator>
+#include <map>
 
 namespace DNACore {
 
     AhoCorasick::AhoCorasick()
-        : stateTransitions_(0), isBuilt_(false) {
-        root_ = std::make_shared<TrieNode>();
+        : classWords_(0), maxPatternLength_(0), stateTransitions_(0), isBuilt_(false) {
+        resetStates();
     }
 
     AhoCorasick::~AhoCorasick() {
     }
 
+    int AhoCorasick::symbolOf(char ch) {
+        return SYMBOL_INDEX[static_cast<unsigned char>(ch)];
+    }
+
     void AhoCorasick::clear() {
-        root_ = std::make_shared<TrieNode>();
         patterns_.clear();
+        resetStates();
+        maxPatternLength_ = 0;
         stateTransitions_ = 0;
         isBuilt_ = false;
     }
 
-    void AhoCorasick::addPattern(const std::string& pattern, const std::string& motifName) {
+    void AhoCorasick::resetStates() {
+        nodes_.clear();
+        transitions_.clear();
+        nextPatternAtState_.clear();
+        classOutputStart_.clear();
+        classOutputs_.clear();
+        classIds_.clear();
+        classEndBits_.clear();
+        classMasks_.clear();
+        classStarts_.clear();
+        classEnds_.clear();
+        classWords_ = 0;
+        addState(0);
+    }
+
+    int AhoCorasick::addState(int depth) {
+        int state = static_cast<int>(nodes_.size());
+        nodes_.emplace_back();
+        nodes_.back().depth = depth;
+        transitions_.resize(transitions_.size() + ALPHABET_SIZE, NO_STATE);
+        return state;
+    }
+
+    void AhoCorasick::addPattern(const std::string& pattern, const std::string& motifName, char strand) {
         if (pattern.empty()) {
             return;
         }
 
+        for (char ch : pattern) {
+            if (symbolOf(ch) == SYMBOL_OTHER && !IUPACCode::isDegenerate(ch)) {
+                return;
+            }
+        }
+
+        // States are built from scratch by buildAutomaton()
         int patternId = static_cast<int>(patterns_.size());
-        patterns_.emplace_back(pattern, motifName, patternId);
-        insertPattern(pattern, motifName, patternId);
+        patterns_.emplace_back(pattern, motifName, patternId, strand);
+        maxPatternLength_ = std::max(maxPatternLength_, pattern.length());
         isBuilt_ = false;  // Need to rebuild automaton
     }
 
-    void AhoCorasick::insertPattern(const std::string& pattern, const std::string& motifName, int patternId) {
-        auto current = root_;
+    void AhoCorasick::addBothStrands(const std::string& pattern, const std::string& motifName) {
+        addPattern(pattern, motifName, '+');
+        if (!IUPACCode::isPalindrome(pattern)) {
+            addPattern(IUPACCode::reverseComplement(pattern), motifName, '-');
+        }
+    }
+
+    void AhoCorasick::insertPattern(const std::string& pattern, int patternId) {
+        int current = ROOT;
         int depth = 0;
 
         for (char ch : pattern) {
             depth++;
 
+            size_t slot = (static_cast<size_t>(current) << SYMBOL_BITS) + symbolOf(ch);
+
             // Create child node if it doesn't exist
-            if (current->children.find(ch) == current->children.end()) {
-                current->children[ch] = std::make_shared<TrieNode>();
-                current->children[ch]->depth = depth;
+            if (transitions_[slot] == NO_STATE) {
+                int child = addState(depth);
+                transitions_[slot] = child;
             }
 
-            current = current->children[ch];
+            current = transitions_[slot];
         }
 
-        // Mark this node as end of pattern
-        current->output.emplace_back(pattern, motifName, patternId);
+        // Mark this node as end of pattern; duplicates chain in insertion order
+        int* slot = &nodes_[current].terminal;
+        while (*slot != NO_PATTERN) {
+            slot = &nextPatternAtState_[*slot];
+        }
+        *slot = patternId;
     }
 
     void AhoCorasick::buildAutomaton() {
@@ -54,123 +105,382 @@ namespace DNACore {
             return;  // Already built
         }
 
-        buildFailureLinks();
+        resetStates();
+
+        bool hasClasses = std::any_of(patterns_.begin(), patterns_.end(),
+            [](const PatternInfo& info) { return IUPACCode::isDegenerate(info.pattern); });
+
+        if (!hasClasses || !buildClassAutomaton()) {
+            // Plain patterns in the trie; degenerate ones (if the subset
+            // construction gave up) in Shift-And words beside it
+            resetStates();
+            nextPatternAtState_.assign(patterns_.size(), NO_PATTERN);
+            for (const auto& info : patterns_) {
+                if (IUPACCode::isDegenerate(info.pattern)) {
+                    classIds_.push_back(info.patternId);
+                }
+                else {
+                    insertPattern(info.pattern, info.patternId);
+                }
+            }
+            buildFailureLinks();
+            buildClassMasks();
+        }
+
         isBuilt_ = true;
     }
 
     void AhoCorasick::buildFailureLinks() {
-        std::queue<std::shared_ptr<TrieNode>> q;
-
-        // Initialize: all children of root have failure link to root
-        for (auto& pair : root_->children) {
-            pair.second->failure = root_;
-            q.push(pair.second);
+        std::queue<int> q;
+
+        // Initialize: all children of root have failure link to root,
+        // missing root edges loop back to root
+        for (int sym = 0; sym < ALPHABET_SIZE; ++sym) {
+            int& next = transitions_[sym];
+            if (next == NO_STATE) {
+                next = ROOT;
+            }
+            else {
+                nodes_[next].failure = ROOT;
+                q.push(next);
+            }
         }
 
         // BFS to build failure links
         while (!q.empty()) {
-            auto current = q.front();
+            int current = q.front();
             q.pop();
 
-            for (auto& pair : current->children) {
-                char ch = pair.first;
-                auto child = pair.second;
+            size_t row = static_cast<size_t>(current) << SYMBOL_BITS;
+            size_t failureRow = static_cast<size_t>(nodes_[current].failure) << SYMBOL_BITS;
+
+            for (int sym = 0; sym < ALPHABET_SIZE; ++sym) {
+                int child = transitions_[row + sym];
+
+                if (child == NO_STATE) {
+                    // Borrow the failure state's (already complete) transition
+                    transitions_[row + sym] = transitions_[failureRow + sym];
+                    continue;
+                }
 
                 q.push(child);
 
-                // Find failure link
-                auto failureNode = current->failure;
+                int failure = transitions_[failureRow + sym];
+                nodes_[child].failure = failure;
+
+                // Dictionary suffix link: the failure state if it ends a
+                // pattern, otherwise whatever it links to (already resolved)
+                nodes_[child].outputLink = nodes_[failure].terminal != NO_PATTERN
+                    ? failure
+                    : nodes_[failure].outputLink;
+            }
+        }
+    }
+
+    std::vector<unsigned char> AhoCorasick::acceptedSymbols(const std::string& pattern) {
+        static const char SYMBOL_BASES[] = "ACGTU";
 
-                while (failureNode != nullptr &&
-                    failureNode->children.find(ch) == failureNode->children.end()) {
-                    if (failureNode == root_) {
-                        break;
+        std::vector<unsigned char> row;
+        row.reserve(pattern.length());
+        for (char ch : pattern) {
+            unsigned bits = 0;
+            if (IUPACCode::isDegenerate(ch)) {
+                // The code itself (only N has a symbol of its own), then its bases
+                if (symbolOf(ch) != SYMBOL_OTHER) {
+                    bits |= 1u << symbolOf(ch);
+                }
+                for (int sym = SYMBOL_A; sym <= SYMBOL_U; ++sym) {
+                    if (IUPACCode::baseMask(SYMBOL_BASES[sym]) & IUPACCode::baseMask(ch)) {
+                        bits |= 1u << sym;
                     }
-                    failureNode = failureNode->failure;
                 }
+            }
+            else {
+                bits = 1u << symbolOf(ch);
+            }
+            row.push_back(static_cast<unsigned char>(bits));
+        }
+        return row;
+    }
 
-                if (failureNode == nullptr || failureNode == root_) {
-                    // Check if root has this character
-                    if (root_->children.find(ch) != root_->children.end() &&
-                        root_->children[ch] != child) {
-                        child->failure = root_->children[ch];
-                    }
-                    else {
-                        child->failure = root_;
+    bool AhoCorasick::buildClassAutomaton() {
+        // Symbols accepted at each pattern position, as a bit per symbol
+        std::vector<std::vector<unsigned char>> accepts(patterns_.size());
+        for (const auto& info : patterns_) {
+            accepts[info.patternId] = acceptedSymbols(info.pattern);
+        }
+
+        // A state is the sorted set of (pattern, matched length) pairs; pairs
+        // with the whole pattern matched only contribute outputs. The root is
+        // the empty set, and every pattern may start at every byte.
+        typedef std::pair<int, int> Item;
+
+        std::vector<Item> starts[ALPHABET_SIZE];
+        for (size_t id = 0; id < accepts.size(); ++id) {
+            for (int sym = 0; sym < ALPHABET_SIZE; ++sym) {
+                if ((accepts[id][0] >> sym) & 1u) {
+                    starts[sym].emplace_back(static_cast<int>(id), 1);
+                }
+            }
+        }
+
+        std::vector<std::vector<Item>> stateItems(1);
+        std::map<std::vector<Item>, int> stateIds;
+        stateIds.emplace(std::vector<Item>(), ROOT);
+        size_t itemCount = 0;
+
+        std::vector<Item> next;
+        for (size_t state = 0; state < stateItems.size(); ++state) {
+            for (int sym = 0; sym < ALPHABET_SIZE; ++sym) {
+                next.clear();
+                for (const auto& item : stateItems[state]) {
+                    const auto& row = accepts[item.first];
+                    if (static_cast<size_t>(item.second) < row.size() && (row[item.second] >> sym) & 1u) {
+                        next.emplace_back(item.first, item.second + 1);
                     }
                 }
+                next.insert(next.end(), starts[sym].begin(), starts[sym].end());
+                std::sort(next.begin(), next.end());
+
+                auto found = stateIds.find(next);
+                int target;
+                if (found != stateIds.end()) {
+                    target = found->second;
+                }
                 else {
-                    child->failure = failureNode->children[ch];
+                    itemCount += next.size();
+                    if (stateItems.size() >= MAX_CLASS_STATES || itemCount > MAX_CLASS_ITEMS) {
+                        return false;
+                    }
+
+                    int depth = 0;
+                    for (const auto& item : next) {
+                        depth = std::max(depth, item.second);
+                    }
+                    target = addState(depth);
+                    stateIds.emplace(next, target);
+                    stateItems.push_back(next);
                 }
+                transitions_[(state << SYMBOL_BITS) + sym] = target;
+            }
+        }
+
+        // Outputs in trie order: longest pattern first, ties by id
+        classOutputStart_.assign(nodes_.size() + 1, 0);
+        std::vector<Item> ending;
+        for (size_t state = 0; state < nodes_.size(); ++state) {
+            classOutputStart_[state] = static_cast<int>(classOutputs_.size());
 
-                // Merge output from failure node
-                if (child->failure != nullptr && child->failure != root_) {
-                    child->output.insert(
-                        child->output.end(),
-                        child->failure->output.begin(),
-                        child->failure->output.end()
-                    );
+            ending.clear();
+            for (const auto& item : stateItems[state]) {
+                if (static_cast<size_t>(item.second) == accepts[item.first].size()) {
+                    ending.emplace_back(-item.second, item.first);
                 }
             }
+            std::sort(ending.begin(), ending.end());
+            for (const auto& item : ending) {
+                classOutputs_.push_back(item.second);
+            }
+        }
+        classOutputStart_[nodes_.size()] = static_cast<int>(classOutputs_.size());
+        return true;
+    }
+
+    void AhoCorasick::buildClassMasks() {
+        size_t totalBits = 0;
+        for (int id : classIds_) {
+            totalBits += patterns_[id].pattern.length();
+        }
+        if (totalBits == 0) {
+            return;
+        }
+
+        classWords_ = (totalBits + 63) / 64;
+        classMasks_.assign(ALPHABET_SIZE * classWords_, 0);
+        classStarts_.assign(classWords_, 0);
+        classEnds_.assign(classWords_, 0);
+
+        // Patterns sit end to end; a start bit is set on every step, so the
+        // bit shifted in from the previous pattern does no harm
+        size_t bit = 0;
+        for (int id : classIds_) {
+            std::vector<unsigned char> row = acceptedSymbols(patterns_[id].pattern);
+            classStarts_[bit / 64] |= uint64_t(1) << (bit % 64);
+            for (unsigned char symbols : row) {
+                for (int sym = 0; sym < ALPHABET_SIZE; ++sym) {
+                    if ((symbols >> sym) & 1u) {
+                        classMasks_[sym * classWords_ + bit / 64] |= uint64_t(1) << (bit % 64);
+                    }
+                }
+                bit++;
+            }
+            classEnds_[(bit - 1) / 64] |= uint64_t(1) << ((bit - 1) % 64);
+            classEndBits_.push_back(bit - 1);
         }
     }
 
     std::vector<MatchResult> AhoCorasick::search(const std::string& text) {
+        if (text.empty() || patterns_.empty()) {
+            return {};
+        }
+
+        if (!isBuilt_) {
+            buildAutomaton();
+        }
+
+        // Exactly one transition per input base
+        stateTransitions_ = text.length();
+
+        return scan(text);
+    }
+
+    std::vector<MatchResult> AhoCorasick::scan(const std::string& text) const {
         std::vector<MatchResult> results;
 
-        if (text.empty() || patterns_.empty()) {
+        if (text.empty() || patterns_.empty() || !isBuilt_) {
             return results;
         }
 
+        ScanState state;
+        advance(state, text.data(), text.length(), 0, results);
+        return results;
+    }
+
+    std::vector<MatchResult> AhoCorasick::searchParallel(const std::string& text, size_t numThreads) {
+        if (text.empty() || patterns_.empty()) {
+            return {};
+        }
+
         if (!isBuilt_) {
             buildAutomaton();
         }
 
-        // Reset statistics
-        stateTransitions_ = 0;
+        stateTransitions_ = text.length();
 
-        auto current = root_;
+        return scanParallel(text, numThreads);
+    }
 
-        for (size_t i = 0; i < text.length(); ++i) {
-            char ch = text[i];
+    std::vector<MatchResult> AhoCorasick::scanParallel(const std::string& text, size_t numThreads) const {
+        if (text.empty() || patterns_.empty() || !isBuilt_) {
+            return {};
+        }
 
-            // Follow failure links until we find a match or reach root
-            while (current != root_ &&
-                current->children.find(ch) == current->children.end()) {
-                current = current->failure;
-                stateTransitions_++;
-            }
+        if (numThreads == 0) {
+            numThreads = ThreadPool::defaultThreadCount();
+        }
 
-            // Transition to next state
-            if (current->children.find(ch) != current->children.end()) {
-                current = current->children[ch];
-                stateTransitions_++;
-            }
-            else {
-                current = root_;
-            }
+        size_t chunkCount = std::min(numThreads, text.length() / MIN_PARALLEL_CHUNK);
+        if (chunkCount <= 1) {
+            return scan(text);
+        }
 
-            // Check for matches at current state
-            for (const auto& patternInfo : current->output) {
-                // Calculate match position safely
-                size_t patternLen = patternInfo.pattern.length();
-                
-                // Ensure we don't underflow
-                if (i + 1 >= patternLen) {
-                    size_t matchPos = i - patternLen + 1;
-                    
-                    results.emplace_back(
-                        matchPos,
-                        patternInfo.pattern,
-                        0,  // editDistance = 0 (exact match)
-                        patternInfo.motifName,
-                        "Aho-Corasick"
-                    );
-                }
-            }
+        size_t chunkSize = (text.length() + chunkCount - 1) / chunkCount;
+        size_t overlap = maxPatternLength_ - 1;
+
+        std::vector<std::future<std::vector<MatchResult>>> futures;
+        futures.reserve(chunkCount);
+
+        for (size_t c = 0; c < chunkCount; ++c) {
+            size_t start = c * chunkSize;
+            size_t end = std::min(text.length(), start + chunkSize);
+
+            futures.push_back(ThreadPool::shared().submit([this, &text, start, end, overlap]() {
+                // Prime over the overlap so only matches ending in [start, end)
+                // are reported; each boundary match belongs to exactly one chunk
+                size_t warmup = std::min(start, overlap);
+                ScanState state;
+                prime(state, text.data() + start - warmup, warmup);
+
+                std::vector<MatchResult> chunkResults;
+                advance(state, text.data() + start, end - start, start, chunkResults);
+                return chunkResults;
+            }));
+        }
+
+        // Chunks are in text order, so concatenation preserves serial order
+        std::vector<std::vector<MatchResult>> parts;
+        parts.reserve(chunkCount);
+        size_t total = 0;
+
+        for (auto& future : futures) {
+            parts.push_back(future.get());
+            total += parts.back().size();
+        }
+
+        std::vector<MatchResult> results;
+        results.reserve(total);
+        for (auto& part : parts) {
+            std::move(part.begin(), part.end(), std::back_inserter(results));
+        }
+
+        return results;
+    }
+
+    void AhoCorasick::prime(ScanState& state, const char* data, size_t length) const {
+        if (classWords_ != 0) {
+            auto ignore = [](size_t, int, size_t, int) {};
+            advanceEach(state, data, length, 0, ignore);
+            return;
+        }
+
+        const int* table = transitions_.data();
+        const unsigned char* symbols = SYMBOL_INDEX.data();
+        int current = state.node;
+
+        for (size_t i = 0; i < length; ++i) {
+            current = table[(static_cast<size_t>(current) << SYMBOL_BITS) +
+                symbols[static_cast<unsigned char>(data[i])]];
+        }
+
+        state.node = current;
+    }
+
+    void AhoCorasick::advance(ScanState& state, const char* data, size_t length, size_t baseOffset,
+        std::vector<MatchResult>& results) const {
+
+        auto collect = [this, &results](size_t position, int patternId, size_t, int editDistance) {
+            const PatternInfo& patternInfo = patterns_[patternId];
+            results.emplace_back(
+                position,
+                patternInfo.pattern,
+                editDistance,  // 0 (exact match)
+                patternInfo.motifName,
+                "Aho-Corasick",
+                patternInfo.strand
+            );
+        };
+
+        advanceEach(state, data, length, baseOffset, collect);
+    }
+
+    // ===== STREAMING SCANNER =====
+
+    AhoCorasick::Scanner::Scanner(const AhoCorasick& automaton)
+        : automaton_(automaton), offset_(0), matchCount_(0) {
+    }
+
+    std::vector<MatchResult> AhoCorasick::Scanner::feed(const char* data, size_t length) {
+        std::vector<MatchResult> results;
+
+        if (length == 0 || automaton_.patterns_.empty() || !automaton_.isBuilt_) {
+            offset_ += length;
+            return results;
         }
 
+        automaton_.advance(state_, data, length, offset_, results);
+        offset_ += length;
+        matchCount_ += results.size();
+
         return results;
     }
 
+    size_t AhoCorasick::Scanner::finish() {
+        // Every match is reported at its last base, so nothing is pending
+        size_t total = matchCount_;
+        state_ = ScanState();
+        offset_ = 0;
+        matchCount_ = 0;
+        return total;
+    }
+
 } // namespace DNACore
\ No newline at end of file
@@ -1,14 +1,39 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <queue>
-#include <memory>
+#include <utility>
 #include "AnalysisTypes.h"
+#include "IUPACCode.h"
+#include "PackedSequence.h"
 
 namespace DNACore {
 
+    namespace detail {
+
+        /**
+         * Byte -> AhoCorasick::Symbol lookup (A, C, G, T, U, N = 0..5, other = 6)
+         */
+        constexpr std::array<unsigned char, 256> makeNucleotideSymbolTable() {
+            std::array<unsigned char, 256> table{};
+            for (auto& entry : table) {
+                entry = 6;
+            }
+            table['A'] = 0;
+            table['C'] = 1;
+            table['G'] = 2;
+            table['T'] = 3;
+            table['U'] = 4;
+            table['N'] = 5;
+            return table;
+        }
+
+    } // namespace detail
+
     /**
      * Aho-Corasick Algorithm for Multi-Pattern String Matching
      * Time Complexity: O(n + m + z) where:
@@ -16,6 +41,24 @@ namespace DNACore {
      *   m = sum of all pattern lengths
      *   z = number of matches
      * Space Complexity: O(m * alphabet_size) for trie
+     *
+     * The trie is stored as a contiguous array of states with a dense goto
+     * table over a remapped nucleotide alphabet, so scanning costs one table
+     * load per base and never follows failure links.
+     *
+     * Patterns may contain IUPAC degenerate codes (see IUPACCode). The
+     * automaton is then built by subset construction instead: a state is
+     * the set of (pattern, matched length) pairs consistent with the text
+     * read so far, and each transition follows every pattern position whose
+     * class holds the symbol. For plain patterns this gives exactly the
+     * trie automaton, and short motifs stay small (NNNNNN needs 7 states,
+     * not 4^6), but the count can grow exponentially with the length of
+     * degenerate runs (A + 63 N + T). Construction therefore stops at
+     * MAX_CLASS_STATES states; the degenerate patterns are then matched by
+     * multi-pattern Shift-And words carried next to a trie of the plain
+     * patterns, costing O(total degenerate length / 64) per base. Text
+     * codes other than N fall into the catch-all symbol, so unlike
+     * IUPACCode::matches a pattern R does not find a text R here.
      */
     class AhoCorasick {
     public:
@@ -26,21 +69,129 @@ namespace DNACore {
             std::string pattern;
             std::string motifName;
             int patternId;
+            char strand;            // '-': reverse complement of the motif
 
-            PatternInfo(const std::string& pat, const std::string& name, int id)
-                : pattern(pat), motifName(name), patternId(id) {
+            PatternInfo(const std::string& pat, const std::string& name, int id, char str = '+')
+                : pattern(pat), motifName(name), patternId(id), strand(str) {
             }
         };
 
+        /**
+         * Remapped input alphabet: A, C, G, T, U, N and a catch-all symbol
+         * for every other byte. Rows are padded to a power of two so a state
+         * index becomes a row offset with a shift.
+         */
+        enum Symbol {
+            SYMBOL_A = 0,
+            SYMBOL_C,
+            SYMBOL_G,
+            SYMBOL_T,
+            SYMBOL_U,
+            SYMBOL_N,
+            SYMBOL_OTHER
+        };
+
+        static constexpr int SYMBOL_BITS = 3;
+        static constexpr int ALPHABET_SIZE = 1 << SYMBOL_BITS;
+
+        // Subset construction limits before falling back to Shift-And
+        static constexpr size_t MAX_CLASS_STATES = 1 << 14;
+        static constexpr size_t MAX_CLASS_ITEMS = 1 << 20;
+
+        /**
+         * Position of a scan: automaton state, plus the Shift-And words of
+         * the degenerate patterns when the automaton fell back to them
+         */
+        struct ScanState {
+            int node;
+            std::vector<uint64_t> words;
+
+            ScanState() : node(0) {}
+        };
+
+        /**
+         * Resumable scanner over chunked input
+         * Holds the automaton state and global offset between feed() calls,
+         * so matches spanning chunk boundaries are reported with their
+         * position in the whole stream. The automaton must be built and must
+         * outlive the scanner.
+         */
+        class Scanner {
+        public:
+            explicit Scanner(const AhoCorasick& automaton);
+
+            /**
+             * Scan the next chunk of the stream
+             * @param data Chunk bytes
+             * @param length Chunk length
+             * @return Matches ending inside this chunk (positions are global)
+             */
+            std::vector<MatchResult> feed(const char* data, size_t length);
+
+            /**
+             * Allocation-free feed(): matches go to sink(position, patternId,
+             * length, editDistance) with global positions
+             * @return false if the sink stopped the scan (call finish() next)
+             */
+            template <typename Sink>
+            bool feedEach(const char* data, size_t length, Sink&& sink) {
+                bool completed = true;
+                if (length != 0 && !automaton_.patterns_.empty() && automaton_.isBuilt_) {
+                    auto counting = [this, &sink](size_t position, int patternId,
+                        size_t matchLength, int editDistance) {
+                        matchCount_++;
+                        return detail::emitMatch(sink, position, patternId, matchLength, editDistance);
+                    };
+                    completed = automaton_.advanceEach(state_, data, length, offset_, counting);
+                }
+                offset_ += length;
+                return completed;
+            }
+
+            /**
+             * End the current stream and reset for the next one
+             * @return Total number of matches reported for the stream
+             */
+            size_t finish();
+
+            /**
+             * Number of bases consumed so far
+             */
+            size_t getOffset() const { return offset_; }
+
+        private:
+            const AhoCorasick& automaton_;
+            ScanState state_;
+            size_t offset_;
+            size_t matchCount_;
+        };
+
         AhoCorasick();
         ~AhoCorasick();
 
         /**
-         * Add a pattern to the trie
+         * Map an input character to its alphabet symbol
+         */
+        static int symbolOf(char ch);
+
+        /**
+         * Add a pattern to the automaton
+         * Patterns may use A/C/G/T/U and the IUPAC degenerate codes; any
+         * other character makes the pattern ignored, since the catch-all
+         * symbol cannot distinguish it.
          * @param pattern The pattern string
          * @param motifName The name/type of this pattern (e.g., "TATA Box")
+         * @param strand Strand reported for its matches ('+' or '-')
+         */
+        void addPattern(const std::string& pattern, const std::string& motifName, char strand = '+');
+
+        /**
+         * Add a pattern for both strands: the pattern itself ('+') and its
+         * reverse complement ('-'), so one forward scan finds minus-strand
+         * sites too, at their forward coordinates. A palindromic pattern
+         * (GAATTC) is added once, since both strands give the same hits.
          */
-        void addPattern(const std::string& pattern, const std::string& motifName);
+        void addBothStrands(const std::string& pattern, const std::string& motifName);
 
         /**
          * Build the automaton (compute failure links)
@@ -55,6 +206,79 @@ namespace DNACore {
          */
         std::vector<MatchResult> search(const std::string& text);
 
+        /**
+         * Search an already built automaton without touching statistics
+         * Safe to call concurrently on a shared, immutable instance
+         * @param text The sequence to search in
+         * @return Vector of MatchResult (empty if the automaton is not built)
+         */
+        std::vector<MatchResult> scan(const std::string& text) const;
+
+        /**
+         * Allocation-free scan of a built automaton
+         * Calls sink(position, patternId, length, editDistance) for every
+         * match, in the same order scan() returns them. Pattern details are
+         * available through getPattern(patternId).
+         * @return false if the sink stopped the scan early
+         */
+        template <typename Sink>
+        bool scanEach(const char* data, size_t length, Sink&& sink) const {
+            if (length == 0 || patterns_.empty() || !isBuilt_) {
+                return true;
+            }
+            ScanState state;
+            return advanceEach(state, data, length, 0, sink);
+        }
+
+        template <typename Sink>
+        bool scanEach(const std::string& text, Sink&& sink) const {
+            return scanEach(text.data(), text.length(), std::forward<Sink>(sink));
+        }
+
+        /**
+         * scanEach() over a 2-bit packed sequence, decoded block by block
+         * with the automaton state carried across blocks
+         */
+        template <typename Sink>
+        bool scanEach(const PackedSequence& text, Sink&& sink) const {
+            if (text.empty() || patterns_.empty() || !isBuilt_) {
+                return true;
+            }
+            ScanState state;
+            size_t offset = 0;
+            return text.forEachBlock([&](std::string_view block) {
+                bool keepGoing = advanceEach(state, block.data(), block.size(), offset, sink);
+                offset += block.size();
+                return keepGoing;
+            });
+        }
+
+        /**
+         * Chunk-parallel search for long sequences
+         * Splits the text into chunks scanned on ThreadPool::shared(); each
+         * chunk primes the automaton over the preceding (max pattern length
+         * - 1) bases, so boundary matches are found exactly once. Results are
+         * identical to search(). Must not be called from a pool task.
+         * @param text The sequence to search in
+         * @param numThreads Number of chunks (0 = hardware concurrency)
+         */
+        std::vector<MatchResult> searchParallel(const std::string& text, size_t numThreads = 0);
+
+        /**
+         * Const counterpart of searchParallel() for built, shared automata
+         */
+        std::vector<MatchResult> scanParallel(const std::string& text, size_t numThreads = 0) const;
+
+        /**
+         * Length of the longest stored pattern
+         */
+        size_t getMaxPatternLength() const { return maxPatternLength_; }
+
+        /**
+         * Check whether buildAutomaton() has run since the last change
+         */
+        bool isBuilt() const { return isBuilt_; }
+
         /**
          * Clear all patterns and reset the automaton
          */
@@ -65,6 +289,22 @@ namespace DNACore {
          */
         size_t getPatternCount() const { return patterns_.size(); }
 
+        /**
+         * Get a stored pattern by the id reported to match sinks
+         */
+        const PatternInfo& getPattern(int patternId) const { return patterns_[patternId]; }
+
+        /**
+         * Get the number of automaton states (including the root)
+         */
+        size_t getStateCount() const { return nodes_.size(); }
+
+        /**
+         * Number of degenerate patterns matched with Shift-And because the
+         * subset construction hit its limits (0 normally)
+         */
+        size_t getBitParallelPatternCount() const { return classIds_.size(); }
+
         /**
          * Get statistics from last search
          */
@@ -73,30 +313,234 @@ namespace DNACore {
     private:
         /**
          * Trie node structure
+         * Children live in the goto table, indexed by state * ALPHABET_SIZE.
+         * Each state stores at most one pattern id; matches are reported by
+         * walking the duplicate chain and then the output links.
          */
         struct TrieNode {
-            std::unordered_map<char, std::shared_ptr<TrieNode>> children;
-            std::shared_ptr<TrieNode> failure;  // Failure link
-            std::vector<PatternInfo> output;     // Patterns that end at this node
+            int failure;                         // Failure link (state index)
+            int terminal;                        // First pattern ending here, or NO_PATTERN
+            int outputLink;                      // Nearest terminal state on the failure chain
             int depth;                           // Depth in trie (for debugging)
 
-            TrieNode() : failure(nullptr), depth(0) {}
+            TrieNode() : failure(0), terminal(NO_PATTERN), outputLink(NO_STATE), depth(0) {}
         };
 
-        std::shared_ptr<TrieNode> root_;
+        static constexpr std::array<unsigned char, 256> SYMBOL_INDEX =
+            detail::makeNucleotideSymbolTable();
+
+        static constexpr int ROOT = 0;
+        static constexpr int NO_STATE = -1;
+        static constexpr int NO_PATTERN = -1;
+
+        std::vector<TrieNode> nodes_;            // State 0 is the root
+        std::vector<int> transitions_;           // Dense goto table
         std::vector<PatternInfo> patterns_;
+        std::vector<int> nextPatternAtState_;    // Duplicate patterns sharing a terminal state
+
+        // Outputs of subset-construction states (at most MAX_CLASS_STATES),
+        // which share no trie chains; empty for the trie
+        std::vector<int> classOutputStart_;      // Per state (plus one): first entry in classOutputs_
+        std::vector<int> classOutputs_;          // Pattern ids ending at each state, longest first
+
+        // Shift-And fallback for degenerate patterns, all packed into one
+        // bit string of classWords_ words
+        std::vector<int> classIds_;              // Pattern ids
+        std::vector<size_t> classEndBits_;       // Last bit of each pattern
+        std::vector<uint64_t> classMasks_;       // Per symbol, classWords_ words
+        std::vector<uint64_t> classStarts_;      // First bit of each pattern
+        std::vector<uint64_t> classEnds_;        // Last bit of each pattern
+        size_t classWords_;
+        size_t maxPatternLength_;
         size_t stateTransitions_;
         bool isBuilt_;
 
+        // Texts shorter than this per chunk are scanned serially
+        static constexpr size_t MIN_PARALLEL_CHUNK = 64 * 1024;
+
+        /**
+         * Drop all states, leaving an empty root
+         */
+        void resetStates();
+
         /**
          * Insert a pattern into the trie
          */
-        void insertPattern(const std::string& pattern, const std::string& motifName, int patternId);
+        void insertPattern(const std::string& pattern, int patternId);
+
+        /**
+         * Append an empty state and its goto row, returning the state index
+         */
+        int addState(int depth);
+
+        /**
+         * Run the automaton over a range starting in the given state,
+         * reporting matches with positions relative to baseOffset
+         * @param state In: starting state, out: state after the last byte read
+         * @return false if the sink stopped the scan early
+         */
+        template <typename Sink>
+        bool advanceEach(ScanState& state, const char* data, size_t length, size_t baseOffset,
+            Sink& sink) const {
+
+            if (classWords_ != 0) {
+                return advanceWithClassesEach(state, data, length, baseOffset, sink);
+            }
+
+            const int* table = transitions_.data();
+            const unsigned char* symbols = SYMBOL_INDEX.data();
+            int current = state.node;
+
+            for (size_t i = 0; i < length; ++i) {
+                // One goto-table load per base; failure links are pre-resolved
+                current = table[(static_cast<size_t>(current) << SYMBOL_BITS) +
+                    symbols[static_cast<unsigned char>(data[i])]];
+
+                // Patterns ending here, longest first
+                bool keepGoing = forEachOutput(current, [&](int id) {
+                    size_t patternLen = patterns_[id].pattern.length();
+                    return detail::emitMatch(sink, baseOffset + i + 1 - patternLen, id, patternLen, 0);
+                });
+                if (!keepGoing) {
+                    state.node = current;
+                    return false;
+                }
+            }
+
+            state.node = current;
+            return true;
+        }
+
+        /**
+         * Call visit(patternId) for every pattern ending in a state, longest
+         * first: the flattened range of a subset-construction state, or the
+         * trie state's duplicate chain followed by its output links
+         * @return false as soon as visit returns false
+         */
+        template <typename Visit>
+        bool forEachOutput(int state, Visit&& visit) const {
+            if (!classOutputStart_.empty()) {
+                for (int k = classOutputStart_[state], last = classOutputStart_[state + 1]; k < last; ++k) {
+                    if (!visit(classOutputs_[k])) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            const TrieNode& node = nodes_[state];
+            int outputState = node.terminal != NO_PATTERN ? state : node.outputLink;
+
+            while (outputState != NO_STATE) {
+                for (int id = nodes_[outputState].terminal; id != NO_PATTERN;
+                    id = nextPatternAtState_[id]) {
+                    if (!visit(id)) {
+                        return false;
+                    }
+                }
+                outputState = nodes_[outputState].outputLink;
+            }
+            return true;
+        }
+
+        /**
+         * advanceEach() for the Shift-And fallback: trie outputs and
+         * degenerate pattern hits are merged per position, longest first
+         */
+        template <typename Sink>
+        bool advanceWithClassesEach(ScanState& state, const char* data, size_t length,
+            size_t baseOffset, Sink& sink) const {
+
+            const int* table = transitions_.data();
+            const unsigned char* symbols = SYMBOL_INDEX.data();
+            const size_t words = classWords_;
+            int current = state.node;
+
+            state.words.resize(words, 0);
+            uint64_t* bits = state.words.data();
+
+            // (length, id) of the patterns ending at one position
+            std::vector<std::pair<size_t, int>> ending;
+
+            for (size_t i = 0; i < length; ++i) {
+                unsigned sym = symbols[static_cast<unsigned char>(data[i])];
+                current = table[(static_cast<size_t>(current) << SYMBOL_BITS) + sym];
+
+                const uint64_t* mask = &classMasks_[sym * words];
+                uint64_t carry = 0;
+                bool classHit = false;
+                for (size_t w = 0; w < words; ++w) {
+                    uint64_t previous = bits[w];
+                    bits[w] = ((previous << 1) | carry | classStarts_[w]) & mask[w];
+                    carry = previous >> 63;
+                    classHit |= (bits[w] & classEnds_[w]) != 0;
+                }
+
+                ending.clear();
+                forEachOutput(current, [&](int id) {
+                    ending.emplace_back(patterns_[id].pattern.length(), id);
+                    return true;
+                });
+                if (!classHit && ending.empty()) {
+                    continue;
+                }
+
+                for (size_t j = 0; classHit && j < classIds_.size(); ++j) {
+                    size_t bit = classEndBits_[j];
+                    if ((bits[bit / 64] >> (bit % 64)) & 1u) {
+                        ending.emplace_back(patterns_[classIds_[j]].pattern.length(), classIds_[j]);
+                    }
+                }
+                std::sort(ending.begin(), ending.end(),
+                    [](const std::pair<size_t, int>& a, const std::pair<size_t, int>& b) {
+                        return a.first != b.first ? a.first > b.first : a.second < b.second;
+                    });
+
+                for (const auto& hit : ending) {
+                    if (!detail::emitMatch(sink, baseOffset + i + 1 - hit.first, hit.second, hit.first, 0)) {
+                        state.node = current;
+                        return false;
+                    }
+                }
+            }
+
+            state.node = current;
+            return true;
+        }
 
         /**
-         * Build failure links using BFS
+         * advanceEach() collecting MatchResult objects
+         */
+        void advance(ScanState& state, const char* data, size_t length, size_t baseOffset,
+            std::vector<MatchResult>& results) const;
+
+        /**
+         * Run the automaton over a range without reporting matches
+         */
+        void prime(ScanState& state, const char* data, size_t length) const;
+
+        /**
+         * Build failure links using BFS and fill in the missing goto
+         * entries so every (state, symbol) pair has a direct transition
          */
         void buildFailureLinks();
+
+        /**
+         * Symbols each pattern position accepts, one bit per symbol
+         */
+        static std::vector<unsigned char> acceptedSymbols(const std::string& pattern);
+
+        /**
+         * Build the goto table and outputs by subset construction over
+         * (pattern, matched length) pairs, for patterns with degenerate codes
+         * @return false if MAX_CLASS_STATES or MAX_CLASS_ITEMS was reached
+         */
+        bool buildClassAutomaton();
+
+        /**
+         * Pack the degenerate patterns into Shift-And masks
+         */
+        void buildClassMasks();
     };
 
 } // namespace DNACore
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace DNACore {
@@ -12,18 +14,151 @@ namespace DNACore {
         int editDistance;             // 0 for exact, >0 for approximate
         std::string motifType;        // "TATA Box", "Exact Match", etc.
         std::string algorithm;        // "KMP", "Aho-Corasick", "PDA", etc. 
+        char strand;                  // '+' forward, '-' reverse complement (position is still forward)
 
         MatchResult()
-            : position(0), editDistance(0), motifType(""), algorithm("") {
+            : position(0), editDistance(0), motifType(""), algorithm(""), strand('+') {
         }
 
         MatchResult(size_t pos, const std::string& seq, int dist = 0,
-            const std::string& type = "", const std::string& algo = "")
+            const std::string& type = "", const std::string& algo = "", char str = '+')
             : position(pos), matchedSequence(seq), editDistance(dist),
-            motifType(type), algorithm(algo) {
+            motifType(type), algorithm(algo), strand(str) {
         }
     };
 
+    // ===== COMPACT MATCH RECORD =====
+    enum class MatchAlgorithm : uint8_t {
+        KMP,
+        AHO_CORASICK,
+        LEVENSHTEIN,
+        PDA,
+        SHIFT_AND,
+        FM_INDEX
+    };
+
+    inline const char* algorithmName(MatchAlgorithm algorithm) {
+        switch (algorithm) {
+        case MatchAlgorithm::KMP: return "KMP";
+        case MatchAlgorithm::AHO_CORASICK: return "Aho-Corasick";
+        case MatchAlgorithm::LEVENSHTEIN: return "Levenshtein";
+        case MatchAlgorithm::PDA: return "PDA";
+        case MatchAlgorithm::SHIFT_AND: return "Shift-And";
+        case MatchAlgorithm::FM_INDEX: return "FM-index";
+        default: return "";
+        }
+    }
+
+    /**
+     * 16-byte, trivially copyable hit record
+     * Strings shared by all hits of a search live in CompactMatchResults;
+     * the matched text is sliced from the sequence on demand. Lengths and
+     * edit distances are stored narrow: searches whose hits could exceed
+     * MAX_LENGTH or MAX_EDIT_DISTANCE must not produce MatchHit records.
+     */
+    struct MatchHit {
+        static constexpr size_t MAX_LENGTH = UINT16_MAX;
+        static constexpr int MAX_EDIT_DISTANCE = UINT8_MAX;
+
+        uint64_t position;            // 0-based position in sequence
+        uint32_t patternId;           // Index into CompactMatchResults::motifTypes
+        uint16_t length;              // Matched length in bases
+        uint8_t editDistance;         // 0 for exact
+        MatchAlgorithm algorithm;
+
+        MatchHit()
+            : position(0), patternId(0), length(0), editDistance(0),
+            algorithm(MatchAlgorithm::KMP) {
+        }
+
+        MatchHit(size_t pos, int id, size_t len, int dist, MatchAlgorithm algo)
+            : position(static_cast<uint64_t>(pos)), patternId(static_cast<uint32_t>(id)),
+            length(static_cast<uint16_t>(len)), editDistance(static_cast<uint8_t>(dist)),
+            algorithm(algo) {
+        }
+    };
+
+    static_assert(sizeof(MatchHit) == 16, "MatchHit must stay 16 bytes");
+    static_assert(std::is_trivially_copyable<MatchHit>::value, "MatchHit must be memcpy-able");
+
+    /**
+     * Compact search result: hit records plus a side table of motif names
+     */
+    struct CompactMatchResults {
+        std::vector<MatchHit> hits;
+        std::vector<std::string> motifTypes;  // Indexed by MatchHit::patternId
+        std::vector<char> strands;            // Indexed by MatchHit::patternId; empty = all '+'
+
+        size_t size() const { return hits.size(); }
+        bool empty() const { return hits.empty(); }
+
+        /**
+         * Matched text, sliced from the searched sequence
+         */
+        std::string matchedSequence(const MatchHit& hit, const std::string& sequence) const {
+            return sequence.substr(static_cast<size_t>(hit.position), hit.length);
+        }
+
+        /**
+         * Expand one hit into a full MatchResult
+         */
+        MatchResult materialize(const MatchHit& hit, const std::string& sequence) const {
+            std::string motifType = hit.patternId < motifTypes.size()
+                ? motifTypes[hit.patternId] : std::string();
+
+            if (hit.algorithm == MatchAlgorithm::LEVENSHTEIN) {
+                motifType += " (dist=" + std::to_string(hit.editDistance) + ")";
+            }
+
+            return MatchResult(
+                static_cast<size_t>(hit.position),
+                matchedSequence(hit, sequence),
+                hit.editDistance,
+                motifType,
+                algorithmName(hit.algorithm),
+                hit.patternId < strands.size() ? strands[hit.patternId] : '+'
+            );
+        }
+
+        /**
+         * Expand every hit, in order
+         */
+        std::vector<MatchResult> materializeAll(const std::string& sequence) const {
+            std::vector<MatchResult> results;
+            results.reserve(hits.size());
+            for (const auto& hit : hits) {
+                results.push_back(materialize(hit, sequence));
+            }
+            return results;
+        }
+    };
+
+    // ===== MATCH SINK =====
+    // Allocation-free search entry points (searchEach/scanEach/feedEach)
+    // report each hit by calling a sink with the signature
+    //     void(size_t position, int patternId, size_t length, int editDistance)
+    // A sink may return bool instead; returning false stops the search.
+    // The vector-returning APIs are adapters that build MatchResult objects.
+
+    namespace detail {
+
+        /**
+         * Deliver one hit to a sink; false means the sink asked to stop
+         */
+        template <typename Sink>
+        inline bool emitMatch(Sink& sink, size_t position, int patternId, size_t length, int editDistance) {
+            using Result = decltype(sink(position, patternId, length, editDistance));
+            if constexpr (std::is_same<Result, bool>::value) {
+                return sink(position, patternId, length, editDistance);
+            }
+            else {
+                sink(position, patternId, length, editDistance);
+                return true;
+            }
+        }
+
+    } // namespace detail
+
     // ===== MOTIF OCCURRENCE =====
     struct MotifOccurrence {
         std::string motifName;        // "TATA Box", "CAAT Box", etc.
@@ -75,10 +210,12 @@ namespace DNACore {
         bool caseSensitive;           // Currently unused (always uppercase)
         bool findOverlapping;         // Allow overlapping matches
         size_t maxResults;            // 0 = unlimited
+        bool useIndex;                // Answer exact queries from an FM-index (built on first use)
+        bool bothStrands;             // Motif scans also find reverse-complement sites
 
         AnalysisOptions()
             : maxEditDistance(2), caseSensitive(false),
-            findOverlapping(true), maxResults(0) {
+            findOverlapping(true), maxResults(0), useIndex(false), bothStrands(true) {
         }
     };
 
@@ -0,0 +1,166 @@
+#include "BatchAnalyzer.h"
+#include <deque>
+#include <future>
+
+namespace DNACore {
+
+    BatchAnalyzer::BatchAnalyzer(const std::vector<BatchAnalysis>& analyses, ThreadPool& pool)
+        : analyses_(analyses), pool_(pool), maxInFlight_(0) {
+        scratch_.resize(pool_.size() + 1);
+    }
+
+    BatchAnalyzer::~BatchAnalyzer() {
+    }
+
+    size_t BatchAnalyzer::windowSize() const {
+        return maxInFlight_ > 0 ? maxInFlight_ : pool_.size() * 4;
+    }
+
+    BatchRecordResult BatchAnalyzer::analyzeRecord(size_t recordId, const std::string& description,
+        const std::string& sequence) {
+
+        // Workers own their slot; the extra slot serves callers outside the pool
+        int worker = pool_.currentWorker();
+        size_t slot = worker < 0 ? pool_.size() : static_cast<size_t>(worker);
+        if (!scratch_[slot]) {
+            scratch_[slot] = std::make_unique<SequenceAnalyzer>();
+        }
+        SequenceAnalyzer& analyzer = *scratch_[slot];
+
+        analyzer.setOptions(options_);
+        analyzer.setSequence(sequence);
+
+        BatchRecordResult result;
+        result.recordId = recordId;
+        result.description = description;
+        result.length = sequence.length();
+        result.matches.resize(analyses_.size());
+
+        for (size_t i = 0; i < analyses_.size(); ++i) {
+            const BatchAnalysis& analysis = analyses_[i];
+
+            switch (analysis.kind) {
+            case BatchAnalysis::Kind::ALL_MOTIFS:
+                result.matches[i] = analyzer.searchAllMotifsCompact();
+                break;
+            case BatchAnalysis::Kind::STATISTICS:
+                result.statistics = analyzer.getStatistics();
+                result.hasStatistics = true;
+                break;
+            case BatchAnalysis::Kind::EXACT_MATCH:
+                result.matches[i] = analyzer.exactMatchCompact(analysis.pattern);
+                break;
+            case BatchAnalysis::Kind::APPROXIMATE_MATCH:
+                result.matches[i] = analyzer.approximateMatchCompact(analysis.pattern, analysis.maxDistance);
+                break;
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<BatchRecordResult> BatchAnalyzer::analyze(const std::vector<FASTARecord>& records) {
+        std::vector<BatchRecordResult> results(records.size());
+        if (records.empty()) {
+            return results;
+        }
+
+        // Several blocks per worker so stealing can even out record lengths
+        size_t blockCount = std::min(records.size(), pool_.size() * 8);
+        size_t blockSize = (records.size() + blockCount - 1) / blockCount;
+
+        std::vector<std::future<void>> futures;
+        futures.reserve(blockCount);
+
+        for (size_t start = 0; start < records.size(); start += blockSize) {
+            size_t end = std::min(start + blockSize, records.size());
+            futures.push_back(pool_.submit([this, &records, &results, start, end]() {
+                for (size_t i = start; i < end; ++i) {
+                    results[i] = analyzeRecord(i, records[i].description, records[i].sequence);
+                }
+            }));
+        }
+
+        for (auto& future : futures) {
+            future.get();
+        }
+
+        return results;
+    }
+
+    FASTAStreamResult BatchAnalyzer::analyzeFile(FASTAParser& parser, const std::string& filepath,
+        const ResultCallback& onResult) {
+
+        std::deque<std::future<BatchRecordResult>> inFlight;
+        const size_t window = windowSize();
+        size_t recordId = 0;
+        bool stopped = false;
+
+        // Deliver the oldest result; futures are kept in input order
+        auto deliverOldest = [&]() {
+            BatchRecordResult result = inFlight.front().get();
+            inFlight.pop_front();
+            if (!stopped && !onResult(result)) {
+                stopped = true;
+            }
+        };
+
+        FASTAStreamResult streamed = parser.streamFile(filepath, [&](FASTARecord& record) {
+            auto shared = std::make_shared<FASTARecord>(std::move(record));
+            size_t id = recordId++;
+
+            inFlight.push_back(pool_.submit([this, shared, id]() {
+                return analyzeRecord(id, shared->description, shared->sequence);
+            }));
+
+            while (inFlight.size() >= window && !stopped) {
+                deliverOldest();
+            }
+            return !stopped;
+        });
+
+        while (!inFlight.empty()) {
+            deliverOldest();
+        }
+
+        streamed.stopped = streamed.stopped || stopped;
+        return streamed;
+    }
+
+    size_t BatchAnalyzer::analyzeMapped(const MappedFASTA& mapped, const ResultCallback& onResult) {
+        std::deque<std::future<BatchRecordResult>> inFlight;
+        const size_t window = windowSize();
+        size_t delivered = 0;
+        bool stopped = false;
+
+        auto deliverOldest = [&]() {
+            BatchRecordResult result = inFlight.front().get();
+            inFlight.pop_front();
+            if (!stopped) {
+                delivered++;
+                stopped = !onResult(result);
+            }
+        };
+
+        for (size_t i = 0; i < mapped.recordCount() && !stopped; ++i) {
+            inFlight.push_back(pool_.submit([this, &mapped, i]() {
+                // A task-local copy, freed with the task; MappedFASTA::sequence()
+                // would keep compacted multi-line records for the mapping's lifetime
+                const FASTARecordView& record = mapped.record(i);
+                return analyzeRecord(i, std::string(record.description),
+                    mapped.extract(record, 0, record.length));
+            }));
+
+            while (inFlight.size() >= window && !stopped) {
+                deliverOldest();
+            }
+        }
+
+        while (!inFlight.empty()) {
+            deliverOldest();
+        }
+
+        return delivered;
+    }
+
+} // namespace DNACore
\ No newline at end of file
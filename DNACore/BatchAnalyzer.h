@@ -0,0 +1,130 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include "AnalysisTypes.h"
+#include "FASTAParser.h"
+#include "SequenceAnalyzer.h"
+#include "ThreadPool.h"
+
+namespace DNACore {
+
+    /**
+     * One analysis to run on every record of a batch
+     */
+    struct BatchAnalysis {
+        enum class Kind {
+            ALL_MOTIFS,           // searchAllMotifsCompact()
+            STATISTICS,           // getStatistics()
+            EXACT_MATCH,          // exactMatchCompact(pattern)
+            APPROXIMATE_MATCH     // approximateMatchCompact(pattern, maxDistance)
+        };
+
+        Kind kind;
+        std::string pattern;
+        int maxDistance;
+
+        BatchAnalysis(Kind k, const std::string& pat = "", int distance = 0)
+            : kind(k), pattern(pat), maxDistance(distance) {
+        }
+
+        static BatchAnalysis motifs() { return BatchAnalysis(Kind::ALL_MOTIFS); }
+        static BatchAnalysis statistics() { return BatchAnalysis(Kind::STATISTICS); }
+        static BatchAnalysis exactMatch(const std::string& pat) { return BatchAnalysis(Kind::EXACT_MATCH, pat); }
+        static BatchAnalysis approximateMatch(const std::string& pat, int distance) {
+            return BatchAnalysis(Kind::APPROXIMATE_MATCH, pat, distance);
+        }
+    };
+
+    /**
+     * Results of all analyses for one record
+     */
+    struct BatchRecordResult {
+        size_t recordId;                            // 0-based position in the input
+        std::string description;                    // Record ID (first word of header)
+        size_t length;                              // Bases analyzed
+        std::vector<CompactMatchResults> matches;   // One per analysis, empty for STATISTICS
+        SequenceStatistics statistics;              // Set if a STATISTICS analysis ran
+        bool hasStatistics;
+
+        BatchRecordResult() : recordId(0), length(0), hasStatistics(false) {}
+    };
+
+    /**
+     * Runs a fixed list of analyses over many records in parallel
+     * Records are analyzed concurrently on a work-stealing ThreadPool, each
+     * worker reusing its own SequenceAnalyzer. Results are always delivered
+     * in input order, tagged with the record id, so output is identical
+     * to a serial run. Must not be called from a task of the same pool.
+     */
+    class BatchAnalyzer {
+    public:
+        /**
+         * Called once per record, in input order. Return false to stop.
+         */
+        using ResultCallback = std::function<bool(BatchRecordResult& result)>;
+
+        explicit BatchAnalyzer(const std::vector<BatchAnalysis>& analyses,
+            ThreadPool& pool = ThreadPool::shared());
+        ~BatchAnalyzer();
+
+        BatchAnalyzer(const BatchAnalyzer&) = delete;
+        BatchAnalyzer& operator=(const BatchAnalyzer&) = delete;
+
+        /**
+         * Options applied to every per-worker analyzer
+         */
+        void setOptions(const AnalysisOptions& options) { options_ = options; }
+        const AnalysisOptions& getOptions() const { return options_; }
+
+        /**
+         * Maximum records queued or running at once in the streaming modes,
+         * which bounds memory to that many records and results
+         * (0 = four per worker)
+         */
+        void setMaxInFlight(size_t maxInFlight) { maxInFlight_ = maxInFlight; }
+
+        /**
+         * Analyze parsed records
+         * @return One result per record, in input order
+         */
+        std::vector<BatchRecordResult> analyze(const std::vector<FASTARecord>& records);
+
+        /**
+         * Stream records from a FASTA file through the analyses
+         * Parsing runs on the calling thread while earlier records are
+         * analyzed on the pool.
+         * @return The parser's stream result (counts and diagnostics)
+         */
+        FASTAStreamResult analyzeFile(FASTAParser& parser, const std::string& filepath,
+            const ResultCallback& onResult);
+
+        /**
+         * Analyze every record of a memory-mapped FASTA file
+         * Each task copies its record out of the mapping and frees the copy
+         * when it finishes, so memory stays bounded by setMaxInFlight()
+         * @return Number of results delivered
+         */
+        size_t analyzeMapped(const MappedFASTA& mapped, const ResultCallback& onResult);
+
+    private:
+        std::vector<BatchAnalysis> analyses_;
+        ThreadPool& pool_;
+        AnalysisOptions options_;
+        size_t maxInFlight_;
+
+        // One analyzer per pool worker, created on first use
+        std::vector<std::unique_ptr<SequenceAnalyzer>> scratch_;
+
+        /**
+         * Run all analyses on one sequence with the calling worker's analyzer
+         */
+        BatchRecordResult analyzeRecord(size_t recordId, const std::string& description,
+            const std::string& sequence);
+
+        size_t windowSize() const;
+    };
+
+} // namespace DNACore
\ No newline at end of file
@@ -0,0 +1,471 @@
+#include "CompositionKernel.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DNACORE_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang compile each kernel for its own instruction set; MSVC accepts
+// the intrinsics without per-function targets
+#if defined(DNACORE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define DNACORE_TARGET_SSE2 __attribute__((target("sse2")))
+#define DNACORE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define DNACORE_TARGET_SSE2
+#define DNACORE_TARGET_AVX2
+#endif
+
+namespace DNACore {
+
+    namespace {
+
+        constexpr int SYMBOL_COUNT = 6;               // A, C, G, T, U, N
+        constexpr char SYMBOLS[SYMBOL_COUNT] = { 'A', 'C', 'G', 'T', 'U', 'N' };
+
+        // Byte counters saturate after 255 additions
+        constexpr size_t MAX_BLOCKS_PER_FLUSH = 255;
+
+        constexpr std::array<unsigned char, 256> makeSymbolIndex() {
+            std::array<unsigned char, 256> table{};
+            for (auto& entry : table) {
+                entry = SYMBOL_COUNT;
+            }
+            for (int i = 0; i < SYMBOL_COUNT; ++i) {
+                table[static_cast<unsigned char>(SYMBOLS[i])] = static_cast<unsigned char>(i);
+            }
+            return table;
+        }
+
+        constexpr std::array<unsigned char, 256> SYMBOL_INDEX = makeSymbolIndex();
+
+        BaseComposition toComposition(const size_t counts[SYMBOL_COUNT], size_t length) {
+            BaseComposition result;
+            result.adenine = counts[0];
+            result.cytosine = counts[1];
+            result.guanine = counts[2];
+            result.thymine = counts[3];
+            result.uracil = counts[4];
+            result.unknown = counts[5];
+
+            size_t known = 0;
+            for (int i = 0; i < SYMBOL_COUNT; ++i) {
+                known += counts[i];
+            }
+            result.other = length - known;
+            return result;
+        }
+
+        void countScalarInto(const char* data, size_t length, size_t counts[SYMBOL_COUNT]) {
+            // Four independent counter sets avoid a store-to-load chain when
+            // neighbouring bases are equal
+            size_t lanes[4][SYMBOL_COUNT + 1] = {};
+            size_t i = 0;
+
+            for (; i + 4 <= length; i += 4) {
+                lanes[0][SYMBOL_INDEX[static_cast<unsigned char>(data[i])]]++;
+                lanes[1][SYMBOL_INDEX[static_cast<unsigned char>(data[i + 1])]]++;
+                lanes[2][SYMBOL_INDEX[static_cast<unsigned char>(data[i + 2])]]++;
+                lanes[3][SYMBOL_INDEX[static_cast<unsigned char>(data[i + 3])]]++;
+            }
+            for (; i < length; ++i) {
+                lanes[0][SYMBOL_INDEX[static_cast<unsigned char>(data[i])]]++;
+            }
+
+            for (int s = 0; s < SYMBOL_COUNT; ++s) {
+                counts[s] += lanes[0][s] + lanes[1][s] + lanes[2][s] + lanes[3][s];
+            }
+        }
+
+        BaseComposition countScalar(const char* data, size_t length) {
+            size_t counts[SYMBOL_COUNT] = {};
+            countScalarInto(data, length, counts);
+            return toComposition(counts, length);
+        }
+
+        // A, C, G, T, U are the first five symbols; N is not a plain nucleotide
+        constexpr unsigned char NUCLEOTIDE_LIMIT = 5;
+
+        size_t nucleotideRunScalar(const char* data, size_t length) {
+            size_t i = 0;
+            while (i < length && SYMBOL_INDEX[static_cast<unsigned char>(data[i])] < NUCLEOTIDE_LIMIT) {
+                ++i;
+            }
+            return i;
+        }
+
+        size_t findLiteralScalar(const char* data, size_t length, const char* literal, size_t literalLength) {
+            if (literalLength > length) {
+                return length;
+            }
+            const char* end = data + length - literalLength + 1;   // One past the last possible start
+            const char* p = data;
+            while (p < end) {
+                p = static_cast<const char*>(std::memchr(p, literal[0], static_cast<size_t>(end - p)));
+                if (p == nullptr) {
+                    break;
+                }
+                if (std::memcmp(p, literal, literalLength) == 0) {
+                    return static_cast<size_t>(p - data);
+                }
+                ++p;
+            }
+            return length;
+        }
+
+#ifdef DNACORE_X86
+
+        inline unsigned lowestSetBit(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+        }
+
+        DNACORE_TARGET_SSE2
+        BaseComposition countSSE2(const char* data, size_t length) {
+            const __m128i zero = _mm_setzero_si128();
+            __m128i symbols[SYMBOL_COUNT];
+            for (int s = 0; s < SYMBOL_COUNT; ++s) {
+                symbols[s] = _mm_set1_epi8(SYMBOLS[s]);
+            }
+
+            size_t counts[SYMBOL_COUNT] = {};
+            size_t i = 0;
+
+            while (length - i >= 16) {
+                size_t blocks = std::min((length - i) / 16, MAX_BLOCKS_PER_FLUSH);
+
+                // cmpeq yields -1 per matching byte; subtracting counts it
+                __m128i acc[SYMBOL_COUNT];
+                for (int s = 0; s < SYMBOL_COUNT; ++s) {
+                    acc[s] = zero;
+                }
+
+                for (size_t b = 0; b < blocks; ++b, i += 16) {
+                    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                    for (int s = 0; s < SYMBOL_COUNT; ++s) {
+                        acc[s] = _mm_sub_epi8(acc[s], _mm_cmpeq_epi8(bytes, symbols[s]));
+                    }
+                }
+
+                // psadbw against zero sums each 8-byte half into a 64-bit lane
+                for (int s = 0; s < SYMBOL_COUNT; ++s) {
+                    alignas(16) uint64_t sums[2];
+                    _mm_store_si128(reinterpret_cast<__m128i*>(sums), _mm_sad_epu8(acc[s], zero));
+                    counts[s] += static_cast<size_t>(sums[0] + sums[1]);
+                }
+            }
+
+            countScalarInto(data + i, length - i, counts);
+            return toComposition(counts, length);
+        }
+
+        DNACORE_TARGET_AVX2
+        BaseComposition countAVX2(const char* data, size_t length) {
+            const __m256i zero = _mm256_setzero_si256();
+            __m256i symbols[SYMBOL_COUNT];
+            for (int s = 0; s < SYMBOL_COUNT; ++s) {
+                symbols[s] = _mm256_set1_epi8(SYMBOLS[s]);
+            }
+
+            size_t counts[SYMBOL_COUNT] = {};
+            size_t i = 0;
+
+            while (length - i >= 32) {
+                size_t blocks = std::min((length - i) / 32, MAX_BLOCKS_PER_FLUSH);
+
+                __m256i acc[SYMBOL_COUNT];
+                for (int s = 0; s < SYMBOL_COUNT; ++s) {
+                    acc[s] = zero;
+                }
+
+                for (size_t b = 0; b < blocks; ++b, i += 32) {
+                    __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                    for (int s = 0; s < SYMBOL_COUNT; ++s) {
+                        acc[s] = _mm256_sub_epi8(acc[s], _mm256_cmpeq_epi8(bytes, symbols[s]));
+                    }
+                }
+
+                for (int s = 0; s < SYMBOL_COUNT; ++s) {
+                    alignas(32) uint64_t sums[4];
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(sums), _mm256_sad_epu8(acc[s], zero));
+                    counts[s] += static_cast<size_t>(sums[0] + sums[1] + sums[2] + sums[3]);
+                }
+            }
+
+            countScalarInto(data + i, length - i, counts);
+            return toComposition(counts, length);
+        }
+
+        DNACORE_TARGET_SSE2
+        size_t nucleotideRunSSE2(const char* data, size_t length) {
+            const __m128i a = _mm_set1_epi8('A');
+            const __m128i c = _mm_set1_epi8('C');
+            const __m128i g = _mm_set1_epi8('G');
+            const __m128i t = _mm_set1_epi8('T');
+            const __m128i u = _mm_set1_epi8('U');
+
+            size_t i = 0;
+            for (; i + 16 <= length; i += 16) {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                __m128i hit = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(bytes, a), _mm_cmpeq_epi8(bytes, c)),
+                    _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, g), _mm_cmpeq_epi8(bytes, t)),
+                        _mm_cmpeq_epi8(bytes, u)));
+
+                unsigned miss = ~static_cast<unsigned>(_mm_movemask_epi8(hit)) & 0xFFFFu;
+                if (miss != 0) {
+                    return i + static_cast<size_t>(lowestSetBit(miss));
+                }
+            }
+
+            return i + nucleotideRunScalar(data + i, length - i);
+        }
+
+        DNACORE_TARGET_AVX2
+        size_t nucleotideRunAVX2(const char* data, size_t length) {
+            const __m256i a = _mm256_set1_epi8('A');
+            const __m256i c = _mm256_set1_epi8('C');
+            const __m256i g = _mm256_set1_epi8('G');
+            const __m256i t = _mm256_set1_epi8('T');
+            const __m256i u = _mm256_set1_epi8('U');
+
+            size_t i = 0;
+            for (; i + 32 <= length; i += 32) {
+                __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                __m256i hit = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(bytes, a), _mm256_cmpeq_epi8(bytes, c)),
+                    _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, g), _mm256_cmpeq_epi8(bytes, t)),
+                        _mm256_cmpeq_epi8(bytes, u)));
+
+                unsigned miss = ~static_cast<unsigned>(_mm256_movemask_epi8(hit));
+                if (miss != 0) {
+                    return i + static_cast<size_t>(lowestSetBit(miss));
+                }
+            }
+
+            return i + nucleotideRunScalar(data + i, length - i);
+        }
+
+        DNACORE_TARGET_SSE2
+        size_t findLiteralSSE2(const char* data, size_t length, const char* literal, size_t literalLength) {
+            const size_t middle = literalLength / 2;
+            const size_t last = literalLength - 1;
+            const __m128i first = _mm_set1_epi8(literal[0]);
+            const __m128i mid = _mm_set1_epi8(literal[middle]);
+            const __m128i tail = _mm_set1_epi8(literal[last]);
+
+            size_t i = 0;
+            for (; i + last + 16 <= length; i += 16) {
+                __m128i hit = _mm_and_si128(
+                    _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), first),
+                    _mm_and_si128(
+                        _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + middle)), mid),
+                        _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + last)), tail)));
+
+                unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+                while (mask != 0) {
+                    size_t start = i + lowestSetBit(mask);
+                    if (std::memcmp(data + start, literal, literalLength) == 0) {
+                        return start;
+                    }
+                    mask &= mask - 1;
+                }
+            }
+
+            return i + findLiteralScalar(data + i, length - i, literal, literalLength);
+        }
+
+        DNACORE_TARGET_AVX2
+        size_t findLiteralAVX2(const char* data, size_t length, const char* literal, size_t literalLength) {
+            const size_t middle = literalLength / 2;
+            const size_t last = literalLength - 1;
+            const __m256i first = _mm256_set1_epi8(literal[0]);
+            const __m256i mid = _mm256_set1_epi8(literal[middle]);
+            const __m256i tail = _mm256_set1_epi8(literal[last]);
+
+            size_t i = 0;
+            for (; i + last + 32 <= length; i += 32) {
+                __m256i hit = _mm256_and_si256(
+                    _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), first),
+                    _mm256_and_si256(
+                        _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + middle)), mid),
+                        _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + last)), tail)));
+
+                unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+                while (mask != 0) {
+                    size_t start = i + lowestSetBit(mask);
+                    if (std::memcmp(data + start, literal, literalLength) == 0) {
+                        return start;
+                    }
+                    mask &= mask - 1;
+                }
+            }
+
+            return i + findLiteralScalar(data + i, length - i, literal, literalLength);
+        }
+
+        bool cpuHasSSE2() {
+#if defined(__x86_64__) || defined(_M_X64)
+            return true;
+#elif defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 1);
+            return (info[3] & (1 << 26)) != 0;
+#else
+            return __builtin_cpu_supports("sse2");
+#endif
+        }
+
+        bool cpuHasAVX2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) {
+                return false;
+            }
+
+            // The OS must save the YMM registers (OSXSAVE + XCR0 bits 1, 2)
+            __cpuid(info, 1);
+            bool osxsave = (info[2] & (1 << 27)) != 0;
+            if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) {
+                return false;
+            }
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+
+#endif // DNACORE_X86
+
+        CompositionKernel::Kernel detectKernel() {
+#ifdef DNACORE_X86
+            if (cpuHasAVX2()) {
+                return CompositionKernel::Kernel::AVX2;
+            }
+            if (cpuHasSSE2()) {
+                return CompositionKernel::Kernel::SSE2;
+            }
+#endif
+            return CompositionKernel::Kernel::SCALAR;
+        }
+
+    } // namespace
+
+    CompositionKernel::Kernel CompositionKernel::activeKernel() {
+        static const Kernel kernel = detectKernel();
+        return kernel;
+    }
+
+    bool CompositionKernel::isSupported(Kernel kernel) {
+        switch (kernel) {
+        case Kernel::AUTO:
+        case Kernel::SCALAR:
+            return true;
+#ifdef DNACORE_X86
+        case Kernel::SSE2:
+            return activeKernel() == Kernel::SSE2 || activeKernel() == Kernel::AVX2;
+        case Kernel::AVX2:
+            return activeKernel() == Kernel::AVX2;
+#endif
+        default:
+            return false;
+        }
+    }
+
+    const char* CompositionKernel::kernelName(Kernel kernel) {
+        switch (kernel) {
+        case Kernel::AUTO: return kernelName(activeKernel());
+        case Kernel::SCALAR: return "scalar";
+        case Kernel::SSE2: return "sse2";
+        case Kernel::AVX2: return "avx2";
+        }
+        return "unknown";
+    }
+
+    BaseComposition CompositionKernel::count(const char* data, size_t length) {
+        return count(data, length, Kernel::AUTO);
+    }
+
+    BaseComposition CompositionKernel::count(const char* data, size_t length, Kernel kernel) {
+        if (kernel == Kernel::AUTO || !isSupported(kernel)) {
+            kernel = isSupported(kernel) ? activeKernel() : Kernel::SCALAR;
+        }
+
+        switch (kernel) {
+#ifdef DNACORE_X86
+        case Kernel::AVX2:
+            return countAVX2(data, length);
+        case Kernel::SSE2:
+            return countSSE2(data, length);
+#endif
+        default:
+            return countScalar(data, length);
+        }
+    }
+
+    size_t CompositionKernel::nucleotideRun(const char* data, size_t length) {
+        return nucleotideRun(data, length, Kernel::AUTO);
+    }
+
+    size_t CompositionKernel::nucleotideRun(const char* data, size_t length, Kernel kernel) {
+        if (kernel == Kernel::AUTO || !isSupported(kernel)) {
+            kernel = isSupported(kernel) ? activeKernel() : Kernel::SCALAR;
+        }
+
+        switch (kernel) {
+#ifdef DNACORE_X86
+        case Kernel::AVX2:
+            return nucleotideRunAVX2(data, length);
+        case Kernel::SSE2:
+            return nucleotideRunSSE2(data, length);
+#endif
+        default:
+            return nucleotideRunScalar(data, length);
+        }
+    }
+
+    size_t CompositionKernel::findLiteral(const char* data, size_t length, const char* literal,
+        size_t literalLength) {
+        return findLiteral(data, length, literal, literalLength, Kernel::AUTO);
+    }
+
+    size_t CompositionKernel::findLiteral(const char* data, size_t length, const char* literal,
+        size_t literalLength, Kernel kernel) {
+        if (literalLength == 0) {
+            return 0;
+        }
+        if (literalLength > length) {
+            return length;
+        }
+        if (kernel == Kernel::AUTO || !isSupported(kernel)) {
+            kernel = isSupported(kernel) ? activeKernel() : Kernel::SCALAR;
+        }
+
+        switch (kernel) {
+#ifdef DNACORE_X86
+        case Kernel::AVX2:
+            return findLiteralAVX2(data, length, literal, literalLength);
+        case Kernel::SSE2:
+            return findLiteralSSE2(data, length, literal, literalLength);
+#endif
+        default:
+            return findLiteralScalar(data, length, literal, literalLength);
+        }
+    }
+
+} // namespace DNACore
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace DNACore {
+
+    /**
+     * Per-symbol base counts of a sequence (uppercase symbols only)
+     */
+    struct BaseComposition {
+        size_t adenine;
+        size_t cytosine;
+        size_t guanine;
+        size_t thymine;
+        size_t uracil;
+        size_t unknown;           // 'N'
+        size_t other;             // Every other byte
+
+        BaseComposition()
+            : adenine(0), cytosine(0), guanine(0), thymine(0), uracil(0), unknown(0), other(0) {
+        }
+
+        size_t total() const { return adenine + cytosine + guanine + thymine + uracil + unknown + other; }
+        size_t gcCount() const { return guanine + cytosine; }
+
+        BaseComposition& operator+=(const BaseComposition& rhs) {
+            adenine += rhs.adenine;
+            cytosine += rhs.cytosine;
+            guanine += rhs.guanine;
+            thymine += rhs.thymine;
+            uracil += rhs.uracil;
+            unknown += rhs.unknown;
+            other += rhs.other;
+            return *this;
+        }
+    };
+
+    /**
+     * Single-pass nucleotide counting
+     * Compares 16 (SSE2) or 32 (AVX2) bytes at a time against each symbol,
+     * accumulating per-lane byte counters that are flushed with a
+     * horizontal sum (psadbw) before they can overflow. The widest kernel
+     * the CPU supports is picked once at runtime; non-x86 builds use the
+     * scalar kernel. Input is expected uppercase, as SequenceAnalyzer
+     * stores it.
+     */
+    class CompositionKernel {
+    public:
+        enum class Kernel {
+            AUTO,                 // Best supported kernel
+            SCALAR,
+            SSE2,
+            AVX2
+        };
+
+        /**
+         * Count bases with the best available kernel
+         */
+        static BaseComposition count(const char* data, size_t length);
+
+        static BaseComposition count(const std::string& sequence) {
+            return count(sequence.data(), sequence.length());
+        }
+
+        /**
+         * Count bases with a specific kernel (falls back to scalar if the
+         * kernel is not supported on this CPU)
+         */
+        static BaseComposition count(const char* data, size_t length, Kernel kernel);
+
+        /**
+         * Length of the leading run of uppercase A, C, G, T, U
+         * (returns length if every byte is a plain nucleotide)
+         */
+        static size_t nucleotideRun(const char* data, size_t length);
+
+        static size_t nucleotideRun(const char* data, size_t length, Kernel kernel);
+
+        /**
+         * Start of the first occurrence of a literal (length if none)
+         * The vector kernels test the literal's first, middle and last bytes
+         * at 16 or 32 positions per step and confirm survivors with memcmp;
+         * the scalar kernel jumps between first-byte hits with memchr.
+         */
+        static size_t findLiteral(const char* data, size_t length, const char* literal, size_t literalLength);
+
+        static size_t findLiteral(const char* data, size_t length, const char* literal, size_t literalLength,
+            Kernel kernel);
+
+        /**
+         * Check whether a kernel can run on this CPU
+         */
+        static bool isSupported(Kernel kernel);
+
+        /**
+         * Kernel chosen for Kernel::AUTO
+         */
+        static Kernel activeKernel();
+
+        /**
+         * Printable kernel name ("scalar", "sse2", "avx2")
+         */
+        static const char* kernelName(Kernel kernel);
+    };
+
+} // namespace DNACore
\ No newline at end of file
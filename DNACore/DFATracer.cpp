@@ -49,25 +49,30 @@ namespace DNACore {
         if (algorithm_ == "KMP") {
             oss << "[3] LPS array computed\n\n";
         }
+        else if (algorithm_ == "FM-index") {
+            oss << "[3] FM-index ready (BWT, occurrence blocks, sampled suffix array)\n\n";
+        }
         else if (algorithm_ == "Aho-Corasick") {
             oss << "[3] Trie built with " << pattern_.length() << " nodes\n";
             oss << "[4] Failure links computed\n\n";
         }
 
-        oss << "[" << (algorithm_ == "KMP" ? 4 : 5) << "] Processing sequence...\n";
+        // KMP and the FM-index need one preparation step, the others two
+        int firstStep = (algorithm_ == "KMP" || algorithm_ == "FM-index") ? 4 : 5;
+        oss << "[" << firstStep << "] Processing sequence...\n";
 
         if (matches_.empty()) {
             oss << "    No matches found\n";
         }
         else {
-            int lineNum = (algorithm_ == "KMP" ? 5 : 6);
+            int lineNum = firstStep + 1;
             for (const auto& match : matches_) {
                 oss << "[" << lineNum++ << "] Pos " << match.first
                     << ": ? MATCH FOUND - " << match.second << "\n";
             }
         }
 
-        oss << "\n[" << (algorithm_ == "KMP" ? 5 : 6) + static_cast<int>(matches_.size())
+        oss << "\n[" << firstStep + 1 + static_cast<int>(matches_.size())
             << "] === ANALYSIS COMPLETE ===\n";
         oss << "    Total Matches: " << matchCount_ << "\n";
 
@@ -75,7 +80,12 @@ namespace DNACore {
             oss << "    Comparisons: " << comparisons_ << "\n";
         }
 
-        oss << "    Complexity: O(n+m)\n";
+        if (algorithm_ == "FM-index") {
+            oss << "    Complexity: O(m + occ * sample rate)\n";
+        }
+        else {
+            oss << "    Complexity: O(n+m)\n";
+        }
 
         return oss.str();
     }
@@ -0,0 +1,212 @@
+#include "FASTAIndex.h"
+#include "MappedFASTA.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace DNACore {
+
+    FASTAIndex::FASTAIndex() {
+    }
+
+    FASTAIndex::~FASTAIndex() {
+    }
+
+    void FASTAIndex::clear() {
+        entries_.clear();
+        byName_.clear();
+        errors_.clear();
+        warnings_.clear();
+    }
+
+    bool FASTAIndex::build(const std::string& fastaPath) {
+        clear();
+
+        // Mapping finds headers and line breaks without copying sequence data
+        MappedFASTA mapped;
+        if (!mapped.open(fastaPath)) {
+            errors_ = mapped.getErrors();
+            return false;
+        }
+
+        if (mapped.data()[0] != '>') {
+            errors_.push_back("Not a FASTA file (missing '>' header): " + fastaPath);
+            return false;
+        }
+
+        for (const auto& record : mapped.records()) {
+            if (!record.isUniform()) {
+                errors_.push_back(
+                    "Different line length in sequence '" + std::string(record.description) + "'"
+                );
+                continue;
+            }
+
+            FASTAIndexEntry entry;
+            entry.name = std::string(record.description);
+            entry.length = record.length;
+            entry.offset = record.offset;
+            entry.lineBases = record.lineBases;
+            entry.lineWidth = record.lineWidth;
+            addEntry(std::move(entry));
+        }
+
+        return errors_.empty();
+    }
+
+    bool FASTAIndex::load(const std::string& faiPath) {
+        clear();
+
+        std::ifstream file(faiPath);
+        if (!file.is_open()) {
+            errors_.push_back("Failed to open index: " + faiPath);
+            return false;
+        }
+
+        std::string line;
+        size_t lineNumber = 0;
+
+        while (std::getline(file, line)) {
+            lineNumber++;
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.empty()) {
+                continue;
+            }
+
+            std::istringstream fields(line);
+            FASTAIndexEntry entry;
+            std::string length, offset, lineBases, lineWidth;
+
+            if (!std::getline(fields, entry.name, '\t') ||
+                !std::getline(fields, length, '\t') ||
+                !std::getline(fields, offset, '\t') ||
+                !std::getline(fields, lineBases, '\t') ||
+                !std::getline(fields, lineWidth, '\t')) {
+                errors_.push_back("Malformed index line " + std::to_string(lineNumber) + " in " + faiPath);
+                return false;
+            }
+
+            try {
+                entry.length = std::stoull(length);
+                entry.offset = std::stoull(offset);
+                entry.lineBases = std::stoull(lineBases);
+                entry.lineWidth = std::stoull(lineWidth);
+            }
+            catch (const std::exception&) {
+                errors_.push_back("Malformed index line " + std::to_string(lineNumber) + " in " + faiPath);
+                return false;
+            }
+
+            if (entry.length > 0 && (entry.lineBases == 0 || entry.lineWidth < entry.lineBases)) {
+                errors_.push_back("Invalid line layout on index line " + std::to_string(lineNumber) +
+                    " in " + faiPath);
+                return false;
+            }
+
+            addEntry(std::move(entry));
+        }
+
+        return true;
+    }
+
+    bool FASTAIndex::save(const std::string& faiPath) const {
+        std::ofstream file(faiPath, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        for (const auto& entry : entries_) {
+            file << entry.name << '\t' << entry.length << '\t' << entry.offset << '\t'
+                << entry.lineBases << '\t' << entry.lineWidth << '\n';
+        }
+
+        return static_cast<bool>(file);
+    }
+
+    void FASTAIndex::addEntry(FASTAIndexEntry entry) {
+        if (byName_.count(entry.name) != 0) {
+            warnings_.push_back("Ignoring duplicate sequence '" + entry.name + "'");
+            return;
+        }
+
+        byName_.emplace(entry.name, entries_.size());
+        entries_.push_back(std::move(entry));
+    }
+
+    const FASTAIndexEntry* FASTAIndex::find(const std::string& name) const {
+        auto it = byName_.find(name);
+        return it != byName_.end() ? &entries_[it->second] : nullptr;
+    }
+
+    bool FASTAIndex::parseCoordinate(const std::string& text, size_t& value) {
+        value = 0;
+        bool sawDigit = false;
+
+        for (char c : text) {
+            if (c == ',') {
+                continue;
+            }
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            value = value * 10 + static_cast<size_t>(c - '0');
+            sawDigit = true;
+        }
+
+        return sawDigit;
+    }
+
+    bool FASTAIndex::resolveRegion(const std::string& text, FASTARegion& region, std::string& error) const {
+        // Whole sequence, including names that contain ':'
+        if (const FASTAIndexEntry* entry = find(text)) {
+            region.name = entry->name;
+            region.start = 0;
+            region.end = entry->length;
+            return true;
+        }
+
+        size_t colon = text.rfind(':');
+        if (colon == std::string::npos) {
+            error = "Unknown sequence: " + text;
+            return false;
+        }
+
+        std::string name = text.substr(0, colon);
+        const FASTAIndexEntry* entry = find(name);
+        if (entry == nullptr) {
+            error = "Unknown sequence: " + name;
+            return false;
+        }
+
+        std::string range = text.substr(colon + 1);
+        size_t dash = range.find('-');
+        size_t first = 0;
+        size_t last = entry->length;
+
+        if (!parseCoordinate(range.substr(0, dash), first) ||
+            (dash != std::string::npos && dash + 1 < range.length() &&
+                !parseCoordinate(range.substr(dash + 1), last))) {
+            error = "Invalid region: " + text;
+            return false;
+        }
+
+        if (first == 0 || last < first) {
+            error = "Invalid region: " + text + " (coordinates are 1-based, start <= end)";
+            return false;
+        }
+
+        if (first > entry->length) {
+            error = "Region start " + std::to_string(first) + " is beyond the end of '" + name +
+                "' (" + std::to_string(entry->length) + " bp)";
+            return false;
+        }
+
+        region.name = name;
+        region.start = first - 1;
+        region.end = std::min(last, entry->length);
+        return true;
+    }
+
+} // namespace DNACore
\ No newline at end of file
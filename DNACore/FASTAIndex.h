@@ -0,0 +1,114 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace DNACore {
+
+    /**
+     * One line of a samtools-compatible .fai index
+     */
+    struct FASTAIndexEntry {
+        std::string name;         // First word of the header
+        size_t length;            // Number of bases
+        size_t offset;            // File offset of the first base
+        size_t lineBases;         // Bases per line
+        size_t lineWidth;         // Bytes per line, including the terminator
+
+        FASTAIndexEntry() : length(0), offset(0), lineBases(0), lineWidth(0) {}
+
+        /**
+         * File offset of a 0-based base position
+         */
+        size_t offsetOf(size_t position) const {
+            return offset + (position / lineBases) * lineWidth + position % lineBases;
+        }
+    };
+
+    /**
+     * A resolved region: 0-based, half-open [start, end)
+     */
+    struct FASTARegion {
+        std::string name;
+        size_t start;
+        size_t end;
+
+        FASTARegion() : start(0), end(0) {}
+
+        size_t length() const { return end - start; }
+    };
+
+    /**
+     * samtools faidx index (name, length, offset, line bases, line width)
+     * Every record must use one line length (the last line may be
+     * shorter), which lets any base be located with arithmetic alone.
+     */
+    class FASTAIndex {
+    public:
+        FASTAIndex();
+        ~FASTAIndex();
+
+        /**
+         * Index a FASTA file
+         * @param fastaPath Path to the FASTA file
+         * @return false if the file cannot be indexed; see getErrors()
+         */
+        bool build(const std::string& fastaPath);
+
+        /**
+         * Read an existing .fai file
+         */
+        bool load(const std::string& faiPath);
+
+        /**
+         * Write the index in .fai format
+         */
+        bool save(const std::string& faiPath) const;
+
+        /**
+         * Resolve a samtools-style region string against the index
+         * Accepts "name", "name:start", "name:start-end" and
+         * "name:start-" with 1-based inclusive coordinates; thousands
+         * separators are allowed ("chr11:5,225,000-5,227,000"). A name that
+         * itself contains ':' matches as a whole first. The end is clipped
+         * to the sequence length.
+         * @param text Region string
+         * @param region Receives the 0-based, half-open region
+         * @param error Receives a message on failure
+         */
+        bool resolveRegion(const std::string& text, FASTARegion& region, std::string& error) const;
+
+        /**
+         * Find an entry by sequence name
+         * @return nullptr if the name is not indexed
+         */
+        const FASTAIndexEntry* find(const std::string& name) const;
+
+        const std::vector<FASTAIndexEntry>& entries() const { return entries_; }
+        size_t size() const { return entries_.size(); }
+        bool empty() const { return entries_.empty(); }
+
+        void clear();
+
+        const std::vector<std::string>& getErrors() const { return errors_; }
+        const std::vector<std::string>& getWarnings() const { return warnings_; }
+
+    private:
+        std::vector<FASTAIndexEntry> entries_;
+        std::unordered_map<std::string, size_t> byName_;
+        std::vector<std::string> errors_;
+        std::vector<std::string> warnings_;
+
+        /**
+         * Append an entry unless its name is already indexed
+         */
+        void addEntry(FASTAIndexEntry entry);
+
+        /**
+         * Parse a 1-based coordinate, ignoring ',' separators
+         */
+        static bool parseCoordinate(const std::string& text, size_t& value);
+    };
+
+} // namespace DNACore
\ No newline at end of file
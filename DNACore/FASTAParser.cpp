@@ -1,9 +1,106 @@
 #include "FASTAParser.h"
+#include <cstring>
+#include <filesystem>
 
 namespace DNACore {
 
+    /**
+     * Buffered reader yielding line pieces without copying them
+     * Lines longer than the buffer are returned in several pieces, so
+     * memory stays bounded by BUFFER_SIZE even for unwrapped sequences.
+     */
+    class FASTAParser::LineReader {
+    public:
+        explicit LineReader(std::istream& input)
+            : input_(&input), buffer_(BUFFER_SIZE), data_(buffer_.data()),
+            pos_(0), end_(0), atLineStart_(true) {
+        }
+
+        LineReader(const char* data, size_t length)
+            : input_(nullptr), data_(data), pos_(0), end_(length), atLineStart_(true) {
+        }
+
+        /**
+         * Get the next piece of the current line (without '\n')
+         * @param lineStart The piece begins a line
+         * @param lineEnd The piece ends a line (newline or end of input)
+         * @return false at end of input
+         */
+        bool next(const char*& piece, size_t& length, bool& lineStart, bool& lineEnd) {
+            if (pos_ == end_ && !refill()) {
+                return false;
+            }
+
+            const char* newline = static_cast<const char*>(
+                std::memchr(data_ + pos_, '\n', end_ - pos_));
+
+            // Pull in more input before splitting a line at the buffer edge
+            if (newline == nullptr && input_ != nullptr && pos_ > 0 && refill()) {
+                newline = static_cast<const char*>(std::memchr(data_ + pos_, '\n', end_ - pos_));
+            }
+
+            piece = data_ + pos_;
+            lineStart = atLineStart_;
+
+            if (newline != nullptr) {
+                length = static_cast<size_t>(newline - piece);
+                pos_ += length + 1;
+                lineEnd = true;
+            }
+            else {
+                length = end_ - pos_;
+                pos_ = end_;
+                lineEnd = input_ == nullptr ||
+                    input_->peek() == std::char_traits<char>::eof();
+            }
+
+            atLineStart_ = lineEnd;
+            return true;
+        }
+
+    private:
+        static constexpr size_t BUFFER_SIZE = 1024 * 1024;
+
+        std::istream* input_;           // nullptr when reading from memory
+        std::vector<char> buffer_;
+        const char* data_;
+        size_t pos_;
+        size_t end_;
+        bool atLineStart_;
+
+        /**
+         * Move unread bytes to the front and read more behind them
+         * @return true if unread bytes are available
+         */
+        bool refill() {
+            if (input_ == nullptr) {
+                return pos_ < end_;
+            }
+
+            size_t remaining = end_ - pos_;
+            if (remaining > 0 && pos_ > 0) {
+                std::memmove(buffer_.data(), buffer_.data() + pos_, remaining);
+            }
+            pos_ = 0;
+            end_ = remaining;
+
+            if (end_ < buffer_.size() && *input_) {
+                input_->read(buffer_.data() + end_, static_cast<std::streamsize>(buffer_.size() - end_));
+                end_ += static_cast<size_t>(input_->gcount());
+            }
+
+            return end_ > 0;
+        }
+    };
+
     FASTAParser::FASTAParser(const Config& config)
-        : config_(config), validator_(config.validatorConfig) {
+        : config_(config), validator_(config.validatorConfig),
+        chunkValidator_(config.validatorConfig) {
+
+        InputValidator::Config chunkConfig = config.validatorConfig;
+        chunkConfig.minLength = 0;
+        chunkConfig.maxLength = 0;
+        chunkValidator_.setConfig(chunkConfig);
     }
 
     FASTAParser::~FASTAParser() {
@@ -34,26 +131,16 @@ namespace DNACore {
             return result;
         }
 
-        // Read entire file
-        std::string content((std::istreambuf_iterator<char>(file)),
-            std::istreambuf_iterator<char>());
-        file.close();
-
-        // Detect format
-        if (content.empty()) {
+        if (fileSize == 0) {
             result.success = false;
             result.errors.push_back("File is empty");
             return result;
         }
 
-        // Check if FASTA format
-        if (content[0] != '>') {
-            // Assume plain text sequence
-            return parsePlainText(content);
-        }
-
-        // Parse FASTA
-        return parseFASTAContent(content);
+        // Records are built straight from the read buffer, without an
+        // intermediate copy of the whole file
+        LineReader reader(file);
+        return collect(reader);
     }
 
     FASTAParseResult FASTAParser::parseString(const std::string& content) {
@@ -64,135 +151,507 @@ namespace DNACore {
             return result;
         }
 
-        if (content[0] == '>') {
-            return parseFASTAContent(content);
+        LineReader reader(content.data(), content.length());
+        return collect(reader);
+    }
+
+    FASTAStreamResult FASTAParser::streamFile(const std::string& filepath, const RecordCallback& onRecord) {
+        std::ifstream file(filepath, std::ios::binary);
+        if (!file.is_open()) {
+            FASTAStreamResult result;
+            result.success = false;
+            result.errors.push_back("Failed to open file: " + filepath);
+            return result;
         }
-        else {
-            return parsePlainText(content);
+
+        if (file.peek() == std::char_traits<char>::eof()) {
+            FASTAStreamResult result;
+            result.success = false;
+            result.errors.push_back("File is empty");
+            return result;
         }
+
+        return streamRecords(file, onRecord);
     }
 
-    FASTAParseResult FASTAParser::parseFASTAContent(const std::string& content) {
+    FASTAStreamResult FASTAParser::streamRecords(std::istream& input, const RecordCallback& onRecord) {
+        LineReader reader(input);
+        return parseStream(reader, 0, &onRecord, nullptr);
+    }
+
+    FASTAStreamResult FASTAParser::streamFileChunks(const std::string& filepath, size_t chunkSize,
+        const ChunkCallback& onChunk) {
+
+        std::ifstream file(filepath, std::ios::binary);
+        if (!file.is_open()) {
+            FASTAStreamResult result;
+            result.success = false;
+            result.errors.push_back("Failed to open file: " + filepath);
+            return result;
+        }
+
+        if (file.peek() == std::char_traits<char>::eof()) {
+            FASTAStreamResult result;
+            result.success = false;
+            result.errors.push_back("File is empty");
+            return result;
+        }
+
+        return streamChunks(file, chunkSize, onChunk);
+    }
+
+    FASTAStreamResult FASTAParser::streamChunks(std::istream& input, size_t chunkSize,
+        const ChunkCallback& onChunk) {
+
+        LineReader reader(input);
+        return parseStream(reader, chunkSize == 0 ? DEFAULT_CHUNK_SIZE : chunkSize, nullptr, &onChunk);
+    }
+
+    MappedFASTA FASTAParser::mapFile(const std::string& filepath) const {
+        MappedFASTA mapped;
+        mapped.open(filepath);
+        return mapped;
+    }
+
+    FASTAIndex FASTAParser::indexFile(const std::string& fastaPath, bool writeIndex) const {
+        FASTAIndex index;
+        std::string faiPath = fastaPath + ".fai";
+
+        std::error_code ec;
+        auto fastaTime = std::filesystem::last_write_time(fastaPath, ec);
+        bool fastaExists = !ec;
+        auto faiTime = std::filesystem::last_write_time(faiPath, ec);
+        bool indexFresh = !ec && fastaExists && faiTime >= fastaTime;
+
+        if (indexFresh && index.load(faiPath)) {
+            return index;
+        }
+
+        // Saving is best-effort; the in-memory index is usable either way
+        if (index.build(fastaPath) && writeIndex) {
+            index.save(faiPath);
+        }
+
+        return index;
+    }
+
+    FASTARegionResult FASTAParser::fetchRegion(const std::string& fastaPath, const FASTAIndex& index,
+        const std::string& region) const {
+
+        FASTARegionResult result;
+        std::string error;
+
+        if (!index.resolveRegion(region, result.region, error)) {
+            result.success = false;
+            result.errors.push_back(error);
+            return result;
+        }
+
+        const FASTAIndexEntry& entry = *index.find(result.region.name);
+        size_t length = result.region.length();
+        if (length == 0) {
+            return result;
+        }
+
+        std::ifstream file(fastaPath, std::ios::binary);
+        if (!file.is_open()) {
+            result.success = false;
+            result.errors.push_back("Failed to open file: " + fastaPath);
+            return result;
+        }
+
+        // Read the covering byte range once, then squeeze out line terminators in place
+        size_t firstByte = entry.offsetOf(result.region.start);
+        size_t lastByte = entry.offsetOf(result.region.end - 1);
+        std::string& bases = result.sequence;
+        bases.resize(lastByte - firstByte + 1);
+
+        file.seekg(static_cast<std::streamoff>(firstByte));
+        file.read(&bases[0], static_cast<std::streamsize>(bases.size()));
+        if (static_cast<size_t>(file.gcount()) != bases.size()) {
+            result.success = false;
+            result.sequence.clear();
+            result.errors.push_back("Index does not match file (read past end): " + fastaPath);
+            return result;
+        }
+
+        size_t column = result.region.start % entry.lineBases;
+        size_t read = 0;
+        size_t written = 0;
+
+        while (written < length) {
+            size_t take = std::min(length - written, entry.lineBases - column);
+            if (read != written) {
+                std::memmove(&bases[written], &bases[read], take);
+            }
+            written += take;
+            read += take + (entry.lineWidth - entry.lineBases);
+            column = 0;
+        }
+        bases.resize(length);
+
+        if (config_.validateSequences) {
+            ValidationResult validation = validator_.validateInPlace(bases);
+            if (!validation.isValid) {
+                result.success = false;
+                result.errors.push_back("Invalid sequence in region '" + region + "'");
+                for (const auto& err : validation.errors) {
+                    result.errors.push_back("  " + err);
+                }
+                result.sequence.clear();
+                return result;
+            }
+            result.warnings = std::move(validation.warnings);
+        }
+
+        return result;
+    }
+
+    FASTAParseResult FASTAParser::collect(LineReader& reader) {
         FASTAParseResult result;
 
-        std::istringstream stream(content);
-        std::string line;
-        FASTARecord currentRecord;
+        RecordCallback append = [&result](FASTARecord& record) {
+            result.records.push_back(std::move(record));
+            return true;
+        };
+        FASTAStreamResult streamed = parseStream(reader, 0, &append, nullptr);
+
+        result.warnings = std::move(streamed.warnings);
+        result.errors = std::move(streamed.errors);
+        result.success = streamed.success;
+        return result;
+    }
+
+    FASTAStreamResult FASTAParser::parseStream(LineReader& reader, size_t chunkSize,
+        const RecordCallback* onRecord, const ChunkCallback* onChunk) {
+
+        FASTAStreamResult result;
+
+        const bool chunked = onChunk != nullptr;
+        bool started = false;
+        bool plainText = false;
         bool inRecord = false;
+        bool inHeader = false;
+        bool recordFailed = false;     // Skipping the rest of an invalid record
+        bool halted = false;           // Stopped by the callback or a fatal error
 
-        while (std::getline(stream, line)) {
-            // Trim whitespace
-            line = trim(line);
+        FASTARecord record;
+        FASTAChunk chunk;
+        std::string header;
+        size_t recordIndex = 0;
+
+        auto isSpace = [](char c) {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+        };
+
+        // A record failed validation: abort unless invalid records are skipped
+        auto rejectRecord = [&]() {
+            if (plainText || !config_.skipInvalidRecords) {
+                result.success = false;
+                halted = true;
+            }
+            recordFailed = true;
+        };
+
+        auto deliverChunk = [&](bool isLast) {
+            chunk.isLast = isLast;
+            if (config_.validateSequences && !chunk.sequence.empty() &&
+                !processChunk(chunk, result.warnings, result.errors)) {
+                rejectRecord();
+                return;
+            }
+
+            result.basesRead += chunk.sequence.length();
+            if (!(*onChunk)(chunk)) {
+                result.stopped = true;
+                halted = true;
+            }
+            chunk.offset += chunk.sequence.length();
+            chunk.isFirst = false;
+            chunk.sequence.clear();
+        };
+
+        auto appendBases = [&](const char* data, size_t length) {
+            if (recordFailed || length == 0) {
+                return;
+            }
 
-            if (line.empty()) continue;
+            if (!chunked) {
+                record.sequence.append(data, length);
+                return;
+            }
 
-            if (line[0] == '>') {
-                // New header
-                if (inRecord) {
-                    // Save previous record
-                    if (!processRecord(currentRecord, result)) {
-                        if (!config_.skipInvalidRecords) {
-                            result.success = false;
-                            return result;
-                        }
+            while (length > 0 && !halted && !recordFailed) {
+                // Flush lazily, so the final chunk of a record is never empty
+                if (chunk.sequence.length() >= chunkSize) {
+                    deliverChunk(false);
+                    continue;
+                }
+                size_t take = std::min(length, chunkSize - chunk.sequence.length());
+                chunk.sequence.append(data, take);
+                data += take;
+                length -= take;
+            }
+        };
+
+        auto beginRecord = [&](std::string recordHeader, std::string description) {
+            inRecord = true;
+            recordFailed = false;
+            if (chunked) {
+                chunk.header = std::move(recordHeader);
+                chunk.description = std::move(description);
+                chunk.sequence.clear();
+                chunk.recordIndex = recordIndex;
+                chunk.offset = 0;
+                chunk.isFirst = true;
+                chunk.isLast = false;
+            }
+            else {
+                record = FASTARecord();
+                record.header = std::move(recordHeader);
+                record.description = std::move(description);
+            }
+        };
+
+        auto endRecord = [&]() {
+            inRecord = false;
+            recordIndex++;
+
+            if (!chunked) {
+                if (!processRecord(record, result.warnings, result.errors)) {
+                    rejectRecord();
+                    return;
+                }
+                result.recordsRead++;
+                result.basesRead += record.sequence.length();
+                if (!(*onRecord)(record)) {
+                    result.stopped = true;
+                    halted = true;
+                }
+                return;
+            }
+
+            if (recordFailed) {
+                return;
+            }
+
+            if (chunk.isFirst && chunk.sequence.empty() && config_.validateSequences) {
+                result.errors.push_back("Invalid sequence in record '" + chunk.description + "'");
+                result.errors.push_back("  Sequence is empty");
+                rejectRecord();
+                return;
+            }
+
+            deliverChunk(true);
+            if (recordFailed) {
+                return;
+            }
+
+            result.recordsRead++;
+            if (config_.validateSequences &&
+                !checkRecordLength(chunk.description, chunk.offset, result.errors)) {
+                rejectRecord();
+            }
+        };
+
+        // Header text is everything after '>' up to the trimmed line end
+        auto endHeader = [&]() {
+            inHeader = false;
+            size_t last = header.find_last_not_of(" \t\r\n");
+            header.erase(last == std::string::npos ? 0 : last + 1);
+            std::string description = extractDescription(header);
+            beginRecord(header, std::move(description));
+        };
+
+        const char* piece;
+        size_t length;
+        bool lineStart;
+        bool lineEnd;
+
+        while (!halted && reader.next(piece, length, lineStart, lineEnd)) {
+            if (!started) {
+                started = true;
+                plainText = length == 0 || piece[0] != '>';
+                if (plainText) {
+                    beginRecord("Unnamed Sequence", "Plain Text Input");
+                }
+            }
+
+            if (plainText) {
+                // Plain text: drop every whitespace character
+                size_t runStart = 0;
+                for (size_t i = 0; i <= length; ++i) {
+                    if (i == length || isSpace(piece[i])) {
+                        appendBases(piece + runStart, i - runStart);
+                        runStart = i + 1;
                     }
                 }
+                continue;
+            }
+
+            if (lineStart) {
+                while (length > 0 && isSpace(*piece)) {
+                    piece++;
+                    length--;
+                }
+
+                if (length > 0 && piece[0] == '>') {
+                    if (inRecord) {
+                        endRecord();
+                        if (halted) {
+                            break;
+                        }
+
+                        // Check if multiple records allowed
+                        if (!config_.allowMultipleRecords && result.recordsRead > 0) {
+                            result.warnings.push_back(
+                                "Multiple records detected, only using first one"
+                            );
+                            break;
+                        }
+                    }
 
-                // Start new record
-                currentRecord = FASTARecord();
-                currentRecord.header = line.substr(1);  // Remove '>'
-                currentRecord.description = extractDescription(currentRecord.header);
-                inRecord = true;
-
-                // Check if multiple records allowed
-                if (!config_.allowMultipleRecords && !result.records.empty()) {
-                    result.warnings.push_back(
-                        "Multiple records detected, only using first one"
-                    );
-                    break;
+                    header.assign(piece + 1, length - 1);
+                    inHeader = true;
+                }
+                else if (length > 0 && !inHeader) {
+                    if (!inRecord) {
+                        result.errors.push_back("Sequence data before header");
+                        result.success = false;
+                        return result;
+                    }
                 }
             }
-            else {
-                // Sequence line
-                if (!inRecord) {
-                    result.errors.push_back("Sequence data before header");
-                    result.success = false;
-                    return result;
+            else if (inHeader) {
+                header.append(piece, length);
+            }
+
+            if (inHeader) {
+                if (lineEnd) {
+                    endHeader();
                 }
-                currentRecord.sequence += line;
+                continue;
             }
-        }
 
-        // Process last record
-        if (inRecord) {
-            if (!processRecord(currentRecord, result)) {
-                if (!config_.skipInvalidRecords) {
-                    result.success = false;
-                    return result;
+            // Sequence line: trailing whitespace is trimmed like the header
+            if (lineEnd) {
+                while (length > 0 && isSpace(piece[length - 1])) {
+                    length--;
                 }
             }
+            appendBases(piece, length);
         }
 
-        if (result.records.empty()) {
+        if (halted) {
+            return result;
+        }
+
+        if (!started) {
             result.success = false;
-            result.errors.push_back("No valid sequences found");
+            result.errors.push_back("Input is empty");
+            return result;
         }
 
-        return result;
-    }
+        // Header on the last line without a newline
+        if (inHeader) {
+            endHeader();
+        }
 
-    FASTAParseResult FASTAParser::parsePlainText(const std::string& content) {
-        FASTAParseResult result;
+        // Process last record
+        if (inRecord) {
+            endRecord();
+            if (halted) {
+                return result;
+            }
+        }
 
-        FASTARecord record;
-        record.header = "Unnamed Sequence";
-        record.description = "Plain Text Input";
-        record.sequence = content;
-
-        // Remove all whitespace
-        record.sequence.erase(
-            std::remove_if(record.sequence.begin(), record.sequence.end(),
-                [](char c) { return std::isspace(static_cast<unsigned char>(c)); }),
-            record.sequence.end()
-        );
-
-        if (!processRecord(record, result)) {
+        if (result.recordsRead == 0 && !plainText) {
             result.success = false;
+            result.errors.push_back("No valid sequences found");
         }
 
         return result;
     }
 
-    bool FASTAParser::processRecord(FASTARecord& record, FASTAParseResult& result) {
+    bool FASTAParser::processRecord(FASTARecord& record, std::vector<std::string>& warnings,
+        std::vector<std::string>& errors) {
+
         // Validate if enabled
         if (config_.validateSequences) {
-            ValidationResult validation = validator_.validate(record.sequence);
+            // Cleaned in place; a rejected record is discarded anyway
+            ValidationResult validation = validator_.validateInPlace(record.sequence);
 
             if (!validation.isValid) {
-                result.errors.push_back(
+                errors.push_back(
                     "Invalid sequence in record '" + record.description + "'"
                 );
                 for (const auto& err : validation.errors) {
-                    result.errors.push_back("  " + err);
+                    errors.push_back("  " + err);
                 }
                 return false;
             }
 
-            // Use cleaned sequence
-            record.sequence = validation.cleanedSequence;
-
             // Propagate warnings
             for (const auto& warn : validation.warnings) {
-                result.warnings.push_back(
+                warnings.push_back(
                     record.description + ": " + warn
                 );
             }
         }
 
-        result.records.push_back(record);
         return true;
     }
 
+    bool FASTAParser::processChunk(FASTAChunk& chunk, std::vector<std::string>& warnings,
+        std::vector<std::string>& errors) {
+
+        ValidationResult validation = chunkValidator_.validateInPlace(chunk.sequence);
+
+        if (!validation.isValid) {
+            errors.push_back(
+                "Invalid sequence in record '" + chunk.description + "' at base " +
+                std::to_string(chunk.offset + 1)
+            );
+            for (const auto& err : validation.errors) {
+                errors.push_back("  " + err);
+            }
+            return false;
+        }
+
+        // Later chunks would repeat the same warnings; report them once
+        if (chunk.isFirst) {
+            for (const auto& warn : validation.warnings) {
+                warnings.push_back(chunk.description + ": " + warn);
+            }
+        }
+
+        return true;
+    }
+
+    bool FASTAParser::checkRecordLength(const std::string& description, size_t length,
+        std::vector<std::string>& errors) const {
+
+        const InputValidator::Config& limits = config_.validatorConfig;
+        std::string error;
+
+        if (length < limits.minLength) {
+            error = "Sequence too short: " + std::to_string(length) +
+                " bp (minimum: " + std::to_string(limits.minLength) + ")";
+        }
+        else if (limits.maxLength > 0 && length > limits.maxLength) {
+            error = "Sequence too long: " + std::to_string(length) +
+                " bp (maximum: " + std::to_string(limits.maxLength) + ")";
+        }
+
+        if (error.empty()) {
+            return true;
+        }
+
+        errors.push_back("Invalid sequence in record '" + description + "'");
+        errors.push_back("  " + error);
+        return false;
+    }
+
     std::string FASTAParser::extractDescription(const std::string& header) const {
         // Extract first word (usually the ID)
         size_t pos = header.find_first_of(" \t");
@@ -202,12 +661,4 @@ namespace DNACore {
         return header.substr(0, pos);
     }
 
-    std::string FASTAParser::trim(const std::string& str) const {
-        size_t start = str.find_first_not_of(" \t\r\n");
-        if (start == std::string::npos) return "";
-
-        size_t end = str.find_last_not_of(" \t\r\n");
-        return str.substr(start, end - start + 1);
-    }
-
 } // namespace DNACore
\ No newline at end of file
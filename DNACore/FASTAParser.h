@@ -1,10 +1,14 @@
 #pragma once
 
 #include "InputValidator.h"
+#include "MappedFASTA.h"
+#include "FASTAIndex.h"
 #include <string>
 #include <vector>
 #include <fstream>
 #include <sstream>
+#include <istream>
+#include <functional>
 
 namespace DNACore {
 
@@ -41,6 +45,54 @@ namespace DNACore {
         }
     };
 
+    /**
+     * Streaming parser result
+     * Records themselves go to the caller's callback; only counts and
+     * diagnostics are kept, so memory does not grow with the input.
+     */
+    struct FASTAStreamResult {
+        size_t recordsRead;       // Records delivered (or fully chunked)
+        size_t basesRead;         // Bases delivered after cleaning
+        std::vector<std::string> warnings;
+        std::vector<std::string> errors;
+        bool success;
+        bool stopped;             // The callback asked to stop
+
+        FASTAStreamResult() : recordsRead(0), basesRead(0), success(true), stopped(false) {}
+    };
+
+    /**
+     * Region fetch result
+     */
+    struct FASTARegionResult {
+        FASTARegion region;       // Resolved 0-based, half-open coordinates
+        std::string sequence;     // Bases of the region
+        std::vector<std::string> warnings;
+        std::vector<std::string> errors;
+        bool success;
+
+        FASTARegionResult() : success(true) {}
+    };
+
+    /**
+     * A fixed-size slice of one record's sequence
+     * The parser reuses a single instance; header and description only
+     * change when isFirst is set.
+     */
+    struct FASTAChunk {
+        std::string header;       // Header of the record this chunk belongs to
+        std::string description;  // First part of header (ID)
+        std::string sequence;     // Cleaned bases of this chunk
+        size_t recordIndex;       // 0-based record number in the input
+        size_t offset;            // Position of the first base within the record
+        bool isFirst;             // First chunk of the record
+        bool isLast;              // Last chunk of the record
+
+        FASTAChunk() : recordIndex(0), offset(0), isFirst(false), isLast(false) {}
+
+        size_t length() const { return sequence.length(); }
+    };
+
     /**
      * FASTA file parser
      */
@@ -78,6 +130,84 @@ namespace DNACore {
          */
         FASTAParseResult parseString(const std::string& content);
 
+        /**
+         * Called once per validated record; the record may be moved from.
+         * Return false to stop parsing.
+         */
+        using RecordCallback = std::function<bool(FASTARecord& record)>;
+
+        /**
+         * Called once per sequence chunk. Return false to stop parsing.
+         */
+        using ChunkCallback = std::function<bool(const FASTAChunk& chunk)>;
+
+        /**
+         * Stream records from a file one at a time
+         * Memory is bounded by the largest record; maxFileSize is not
+         * applied since nothing accumulates.
+         * @param filepath Path to FASTA file
+         * @param onRecord Receives each record after validation
+         * @return Counts and diagnostics (no records)
+         */
+        FASTAStreamResult streamFile(const std::string& filepath, const RecordCallback& onRecord);
+
+        /**
+         * Stream records from any input stream
+         */
+        FASTAStreamResult streamRecords(std::istream& input, const RecordCallback& onRecord);
+
+        /**
+         * Stream a file as fixed-size sequence chunks
+         * Memory is bounded by chunkSize plus the read buffer, regardless of
+         * record or line length. Each chunk is validated on its own; length
+         * limits are checked against the whole record when it ends. A record
+         * that fails validation is reported in errors, but chunks already
+         * delivered for it are not retracted.
+         * @param filepath Path to FASTA file
+         * @param chunkSize Maximum bases per chunk (0 = DEFAULT_CHUNK_SIZE)
+         * @param onChunk Receives each chunk
+         */
+        FASTAStreamResult streamFileChunks(const std::string& filepath, size_t chunkSize,
+            const ChunkCallback& onChunk);
+
+        /**
+         * Stream chunks from any input stream
+         */
+        FASTAStreamResult streamChunks(std::istream& input, size_t chunkSize,
+            const ChunkCallback& onChunk);
+
+        static constexpr size_t DEFAULT_CHUNK_SIZE = 512 * 1024;
+
+        /**
+         * Memory-map a FASTA file and index its records without copying
+         * Startup cost is one memchr pass over the file; sequences are
+         * read on demand through the returned views. No validation is
+         * applied and maxFileSize does not limit mapped files.
+         * @param filepath Path to FASTA file
+         * @return Mapped file; check isOpen() and getErrors()
+         */
+        MappedFASTA mapFile(const std::string& filepath) const;
+
+        /**
+         * Load the .fai index next to a FASTA file, building it if it is
+         * missing or older than the FASTA file
+         * @param fastaPath Path to FASTA file (index is fastaPath + ".fai")
+         * @param writeIndex Save a newly built index next to the file
+         * @return Index; check getErrors() if it is empty
+         */
+        FASTAIndex indexFile(const std::string& fastaPath, bool writeIndex = true) const;
+
+        /**
+         * Read one region by seeking straight to its bytes
+         * Cost is O(region length), independent of the file size.
+         * @param fastaPath Path to the indexed FASTA file
+         * @param index Index of that file (see indexFile)
+         * @param region samtools-style region, e.g. "chr11:5,225,000-5,227,000"
+         * @return Region bases, validated when validateSequences is set
+         */
+        FASTARegionResult fetchRegion(const std::string& fastaPath, const FASTAIndex& index,
+            const std::string& region) const;
+
         /**
          * Get current configuration
          */
@@ -86,31 +216,43 @@ namespace DNACore {
     private:
         Config config_;
         InputValidator validator_;
+        InputValidator chunkValidator_;      // validator_ without length limits
+
+        class LineReader;
 
         /**
-         * Parse FASTA content
+         * Shared record/chunk parsing loop; exactly one callback is set
          */
-        FASTAParseResult parseFASTAContent(const std::string& content);
+        FASTAStreamResult parseStream(LineReader& reader, size_t chunkSize,
+            const RecordCallback* onRecord, const ChunkCallback* onChunk);
 
         /**
-         * Parse plain text (no FASTA header)
+         * Validate a complete record in place
          */
-        FASTAParseResult parsePlainText(const std::string& content);
+        bool processRecord(FASTARecord& record, std::vector<std::string>& warnings,
+            std::vector<std::string>& errors);
 
         /**
-         * Process a single record
+         * Validate one chunk in place (length limits excluded)
          */
-        bool processRecord(FASTARecord& record, FASTAParseResult& result);
+        bool processChunk(FASTAChunk& chunk, std::vector<std::string>& warnings,
+            std::vector<std::string>& errors);
 
         /**
-         * Extract description from header
+         * Apply minLength/maxLength to a chunked record's total length
          */
-        std::string extractDescription(const std::string& header) const;
+        bool checkRecordLength(const std::string& description, size_t length,
+            std::vector<std::string>& errors) const;
 
         /**
-         * Trim whitespace
+         * Collect streamed records into a FASTAParseResult
          */
-        std::string trim(const std::string& str) const;
+        FASTAParseResult collect(LineReader& reader);
+
+        /**
+         * Extract description from header
+         */
+        std::string extractDescription(const std::string& header) const;
     };
 
 } // namespace DNACore
\ No newline at end of file
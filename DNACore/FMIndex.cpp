@@ -0,0 +1,527 @@
+#include "FMIndex.h"
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace DNACore {
+
+    namespace {
+
+        constexpr char FILE_MAGIC[8] = { 'D', 'N', 'A', 'F', 'M', 'I', 'D', 'X' };
+        constexpr uint32_t FILE_VERSION = 1;
+
+        // SA-IS works on int32 positions and needs one extra (sentinel) slot
+        constexpr size_t MAX_TEXT_LENGTH = static_cast<size_t>(std::numeric_limits<int32_t>::max()) - 1;
+
+        /**
+         * Suffix type per position: S (true) or L (false)
+         */
+        class TypeBits {
+        public:
+            explicit TypeBits(size_t n) : bits_((n + 63) / 64, 0) {}
+
+            bool get(size_t i) const { return (bits_[i / 64] >> (i % 64)) & 1u; }
+
+            void set(size_t i, bool value) {
+                uint64_t mask = 1ULL << (i % 64);
+                bits_[i / 64] = value ? (bits_[i / 64] | mask) : (bits_[i / 64] & ~mask);
+            }
+
+        private:
+            std::vector<uint64_t> bits_;
+        };
+
+        /**
+         * Start (end = false) or end (end = true) of each symbol's bucket
+         */
+        template <typename Symbol>
+        void getBuckets(const Symbol* s, int32_t n, int32_t* bucket, int32_t alphabet, bool end) {
+            std::fill(bucket, bucket + alphabet, 0);
+            for (int32_t i = 0; i < n; ++i) {
+                bucket[s[i]]++;
+            }
+            int32_t sum = 0;
+            for (int32_t c = 0; c < alphabet; ++c) {
+                sum += bucket[c];
+                bucket[c] = end ? sum : sum - bucket[c];
+            }
+        }
+
+        template <typename Symbol>
+        void induceL(const TypeBits& type, int32_t* sa, const Symbol* s, int32_t* bucket,
+            int32_t n, int32_t alphabet) {
+
+            getBuckets(s, n, bucket, alphabet, false);
+            for (int32_t i = 0; i < n; ++i) {
+                int32_t j = sa[i] - 1;
+                if (j >= 0 && !type.get(j)) {
+                    sa[bucket[s[j]]++] = j;
+                }
+            }
+        }
+
+        template <typename Symbol>
+        void induceS(const TypeBits& type, int32_t* sa, const Symbol* s, int32_t* bucket,
+            int32_t n, int32_t alphabet) {
+
+            getBuckets(s, n, bucket, alphabet, true);
+            for (int32_t i = n - 1; i >= 0; --i) {
+                int32_t j = sa[i] - 1;
+                if (j >= 0 && type.get(j)) {
+                    sa[--bucket[s[j]]] = j;
+                }
+            }
+        }
+
+        /**
+         * SA-IS (Nong, Zhang & Chan 2009)
+         * s[n - 1] must be a unique sentinel smaller than every other
+         * symbol; all symbols are in [0, alphabet).
+         */
+        template <typename Symbol>
+        void suffixArray(const Symbol* s, int32_t* sa, int32_t n, int32_t alphabet) {
+            TypeBits type(static_cast<size_t>(n));
+            type.set(n - 1, true);
+            if (n >= 2) {
+                type.set(n - 2, false);
+            }
+            for (int32_t i = n - 3; i >= 0; --i) {
+                type.set(i, s[i] < s[i + 1] || (s[i] == s[i + 1] && type.get(i + 1)));
+            }
+
+            auto isLMS = [&type](int32_t i) {
+                return i > 0 && type.get(i) && !type.get(i - 1);
+            };
+
+            // Stage 1: sort the LMS substrings by induction
+            std::vector<int32_t> bucket(static_cast<size_t>(alphabet));
+            getBuckets(s, n, bucket.data(), alphabet, true);
+            std::fill(sa, sa + n, -1);
+            for (int32_t i = 1; i < n; ++i) {
+                if (isLMS(i)) {
+                    sa[--bucket[s[i]]] = i;
+                }
+            }
+            induceL(type, sa, s, bucket.data(), n, alphabet);
+            induceS(type, sa, s, bucket.data(), n, alphabet);
+
+            // Compact the sorted LMS substrings into the first n1 slots
+            int32_t n1 = 0;
+            for (int32_t i = 0; i < n; ++i) {
+                if (isLMS(sa[i])) {
+                    sa[n1++] = sa[i];
+                }
+            }
+
+            // Name them; equal substrings share a name
+            std::fill(sa + n1, sa + n, -1);
+            int32_t name = 0;
+            int32_t previous = -1;
+            for (int32_t i = 0; i < n1; ++i) {
+                int32_t position = sa[i];
+                bool differs = false;
+                for (int32_t d = 0; d < n; ++d) {
+                    if (previous == -1 || s[position + d] != s[previous + d] ||
+                        type.get(position + d) != type.get(previous + d)) {
+                        differs = true;
+                        break;
+                    }
+                    if (d > 0 && (isLMS(position + d) || isLMS(previous + d))) {
+                        break;
+                    }
+                }
+                if (differs) {
+                    name++;
+                    previous = position;
+                }
+                sa[n1 + position / 2] = name - 1;
+            }
+            for (int32_t i = n - 1, j = n - 1; i >= n1; --i) {
+                if (sa[i] >= 0) {
+                    sa[j--] = sa[i];
+                }
+            }
+
+            // Stage 2: sort the reduced string, recursing while names repeat
+            int32_t* reduced = sa + n - n1;
+            if (name < n1) {
+                suffixArray(reduced, sa, n1, name);
+            }
+            else {
+                for (int32_t i = 0; i < n1; ++i) {
+                    sa[reduced[i]] = i;
+                }
+            }
+
+            // Stage 3: place the LMS suffixes in order and induce the rest
+            getBuckets(s, n, bucket.data(), alphabet, true);
+            for (int32_t i = 1, j = 0; i < n; ++i) {
+                if (isLMS(i)) {
+                    reduced[j++] = i;
+                }
+            }
+            for (int32_t i = 0; i < n1; ++i) {
+                sa[i] = reduced[sa[i]];
+            }
+            std::fill(sa + n1, sa + n, -1);
+            for (int32_t i = n1 - 1; i >= 0; --i) {
+                int32_t j = sa[i];
+                sa[i] = -1;
+                sa[--bucket[s[j]]] = j;
+            }
+            induceL(type, sa, s, bucket.data(), n, alphabet);
+            induceS(type, sa, s, bucket.data(), n, alphabet);
+        }
+
+        /**
+         * Remap the text to dense symbols 1..k (0 is the sentinel) and build
+         * its suffix array, sentinel suffix first
+         */
+        template <typename Symbol>
+        std::vector<int32_t> buildSuffixArray(const char* text, size_t length) {
+            int32_t rankOf[256] = {};
+            for (size_t i = 0; i < length; ++i) {
+                rankOf[static_cast<unsigned char>(text[i])] = 1;
+            }
+            int32_t alphabet = 1;
+            for (auto& rank : rankOf) {
+                rank = rank ? alphabet++ : 0;
+            }
+
+            std::vector<Symbol> symbols(length + 1);
+            for (size_t i = 0; i < length; ++i) {
+                symbols[i] = static_cast<Symbol>(rankOf[static_cast<unsigned char>(text[i])]);
+            }
+            symbols[length] = 0;
+
+            std::vector<int32_t> sa(length + 1);
+            suffixArray(symbols.data(), sa.data(), static_cast<int32_t>(length + 1), alphabet);
+            return sa;
+        }
+
+        template <typename T>
+        void writeVector(std::ofstream& file, const std::vector<T>& values) {
+            uint64_t count = values.size();
+            file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(count * sizeof(T)));
+        }
+
+        template <typename T>
+        bool readVector(std::ifstream& file, std::vector<T>& values, uint64_t maxCount) {
+            uint64_t count = 0;
+            if (!file.read(reinterpret_cast<char*>(&count), sizeof(count)) || count > maxCount) {
+                return false;
+            }
+            values.resize(static_cast<size_t>(count));
+            return static_cast<bool>(file.read(reinterpret_cast<char*>(values.data()),
+                static_cast<std::streamsize>(count * sizeof(T))));
+        }
+
+    } // namespace
+
+    FMIndex::FMIndex()
+        : symbolCount_(0), sentinelRow_(0), sampleRate_(DEFAULT_SAMPLE_RATE), checksum_(0) {
+    }
+
+    FMIndex::~FMIndex() {
+    }
+
+    void FMIndex::clear() {
+        bwt_.clear();
+        occ_.clear();
+        sampledRows_.clear();
+        sampledRank_.clear();
+        samples_.clear();
+        firstRow_.clear();
+        slot_.clear();
+        symbolCount_ = 0;
+        sentinelRow_ = 0;
+        sampleRate_ = DEFAULT_SAMPLE_RATE;
+        checksum_ = 0;
+        errors_.clear();
+    }
+
+    uint64_t FMIndex::checksumOf(const char* text, size_t length) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < length; ++i) {
+            hash ^= static_cast<unsigned char>(text[i]);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    size_t FMIndex::memoryUsage() const {
+        return bwt_.capacity() + occ_.capacity() * sizeof(uint32_t) +
+            sampledRows_.capacity() * sizeof(uint32_t) + sampledRank_.capacity() * sizeof(uint32_t) +
+            samples_.capacity() * sizeof(uint32_t) + firstRow_.capacity() * sizeof(size_t) +
+            slot_.capacity() * sizeof(int);
+    }
+
+    bool FMIndex::build(const char* text, size_t length, uint32_t sampleRate) {
+        clear();
+
+        if (length == 0) {
+            return true;
+        }
+        if (length > MAX_TEXT_LENGTH) {
+            errors_.push_back("Sequence too long to index: " + std::to_string(length) + " bp");
+            return false;
+        }
+
+        sampleRate_ = sampleRate == 0 ? 1 : sampleRate;
+        checksum_ = checksumOf(text, length);
+
+        // Up to 256 byte values plus the sentinel need 16-bit symbols
+        bool wideAlphabet = false;
+        {
+            bool present[256] = {};
+            size_t distinct = 0;
+            for (size_t i = 0; i < length && !wideAlphabet; ++i) {
+                unsigned char byte = static_cast<unsigned char>(text[i]);
+                if (!present[byte]) {
+                    present[byte] = true;
+                    wideAlphabet = ++distinct > 255;
+                }
+            }
+        }
+        std::vector<int32_t> sa = wideAlphabet
+            ? buildSuffixArray<uint16_t>(text, length)
+            : buildSuffixArray<unsigned char>(text, length);
+
+        // BWT and suffix array samples; the full suffix array is dropped
+        const size_t rows = length + 1;
+        bwt_.resize(rows);
+        sampledRows_.assign((rows + 31) / 32, 0);
+        samples_.reserve(rows / sampleRate_ + 1);
+
+        for (size_t row = 0; row < rows; ++row) {
+            size_t position = static_cast<size_t>(sa[row]);
+            if (position == 0) {
+                sentinelRow_ = row;
+                bwt_[row] = 0;
+            }
+            else {
+                bwt_[row] = static_cast<unsigned char>(text[position - 1]);
+            }
+
+            if (position % sampleRate_ == 0) {
+                sampledRows_[row / 32] |= 1u << (row % 32);
+                samples_.push_back(static_cast<uint32_t>(position));
+            }
+        }
+
+        buildOccurrences();
+        return true;
+    }
+
+    void FMIndex::buildOccurrences() {
+        const size_t rows = bwt_.size();
+
+        // Symbol columns; the sentinel row's placeholder is excluded
+        size_t totals[256] = {};
+        for (size_t row = 0; row < rows; ++row) {
+            if (row != sentinelRow_) {
+                totals[bwt_[row]]++;
+            }
+        }
+
+        slot_.assign(256, -1);
+        firstRow_.assign(256, 0);
+        symbolCount_ = 0;
+        size_t next = 1;                      // Row 0 is the sentinel suffix
+        for (int c = 0; c < 256; ++c) {
+            firstRow_[c] = next;
+            if (totals[c] > 0) {
+                slot_[c] = static_cast<int>(symbolCount_++);
+                next += totals[c];
+            }
+        }
+
+        const size_t blocks = rows / OCC_BLOCK + 1;
+        occ_.assign(blocks * symbolCount_, 0);
+        std::vector<uint32_t> running(symbolCount_, 0);
+
+        for (size_t row = 0; row < rows; ++row) {
+            if (row % OCC_BLOCK == 0) {
+                std::copy(running.begin(), running.end(), occ_.begin() + (row / OCC_BLOCK) * symbolCount_);
+            }
+            if (row != sentinelRow_) {
+                running[slot_[bwt_[row]]]++;
+            }
+        }
+        if (rows % OCC_BLOCK == 0) {
+            std::copy(running.begin(), running.end(), occ_.begin() + (rows / OCC_BLOCK) * symbolCount_);
+        }
+
+        sampledRank_.assign(sampledRows_.size(), 0);
+        uint32_t sampled = 0;
+        for (size_t word = 0; word < sampledRows_.size(); ++word) {
+            sampledRank_[word] = sampled;
+            uint32_t bits = sampledRows_[word];
+            while (bits != 0) {
+                bits &= bits - 1;
+                sampled++;
+            }
+        }
+    }
+
+    size_t FMIndex::rank(unsigned char c, size_t row) const {
+        const size_t block = row / OCC_BLOCK;
+        size_t result = occ_[block * symbolCount_ + static_cast<size_t>(slot_[c])];
+
+        const unsigned char* data = bwt_.data();
+        for (size_t i = block * OCC_BLOCK; i < row; ++i) {
+            result += data[i] == c;
+        }
+
+        // The sentinel row stores 0 but is not an occurrence of byte 0
+        if (c == 0 && sentinelRow_ >= block * OCC_BLOCK && sentinelRow_ < row) {
+            result--;
+        }
+        return result;
+    }
+
+    void FMIndex::backwardSearch(const std::string& pattern, size_t& begin, size_t& end) const {
+        begin = 0;
+        end = bwt_.size();
+
+        for (size_t i = pattern.length(); i-- > 0 && begin < end;) {
+            unsigned char c = static_cast<unsigned char>(pattern[i]);
+            if (slot_[c] < 0) {
+                begin = end = 0;
+                return;
+            }
+            begin = firstRow_[c] + rank(c, begin);
+            end = firstRow_[c] + rank(c, end);
+        }
+    }
+
+    size_t FMIndex::textPosition(size_t row) const {
+        size_t steps = 0;
+
+        // The sentinel row holds text position 0, which is always sampled
+        while (!isSampled(row)) {
+            unsigned char c = bwt_[row];
+            row = firstRow_[c] + rank(c, row);
+            steps++;
+        }
+
+        size_t word = row / 32;
+        uint32_t below = sampledRows_[word] & ((1u << (row % 32)) - 1);
+        size_t index = sampledRank_[word];
+        while (below != 0) {
+            below &= below - 1;
+            index++;
+        }
+        return samples_[index] + steps;
+    }
+
+    size_t FMIndex::count(const std::string& pattern) const {
+        if (bwt_.empty() || pattern.empty() || pattern.length() > textLength()) {
+            return 0;
+        }
+
+        size_t begin;
+        size_t end;
+        backwardSearch(pattern, begin, end);
+        return end > begin ? end - begin : 0;
+    }
+
+    std::vector<size_t> FMIndex::locate(const std::string& pattern) const {
+        std::vector<size_t> positions;
+        if (bwt_.empty() || pattern.empty() || pattern.length() > textLength()) {
+            return positions;
+        }
+
+        size_t begin;
+        size_t end;
+        backwardSearch(pattern, begin, end);
+        if (end <= begin) {
+            return positions;
+        }
+
+        positions.reserve(end - begin);
+        for (size_t row = begin; row < end; ++row) {
+            positions.push_back(textPosition(row));
+        }
+        std::sort(positions.begin(), positions.end());
+        return positions;
+    }
+
+    bool FMIndex::save(const std::string& path) const {
+        std::ofstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        uint64_t header[4] = { sentinelRow_, sampleRate_, checksum_, symbolCount_ };
+        file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+        file.write(reinterpret_cast<const char*>(&FILE_VERSION), sizeof(FILE_VERSION));
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+        writeVector(file, bwt_);
+        writeVector(file, sampledRows_);
+        writeVector(file, samples_);
+
+        return static_cast<bool>(file);
+    }
+
+    bool FMIndex::load(const std::string& path) {
+        clear();
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            errors_.push_back("Cannot open index: " + path);
+            return false;
+        }
+
+        char magic[sizeof(FILE_MAGIC)] = {};
+        uint32_t version = 0;
+        uint64_t header[4] = {};
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char*>(&version), sizeof(version));
+        file.read(reinterpret_cast<char*>(header), sizeof(header));
+
+        if (!file || std::memcmp(magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+            errors_.push_back("Not an FM-index file: " + path);
+            return false;
+        }
+        if (version != FILE_VERSION) {
+            errors_.push_back("Unsupported FM-index version " + std::to_string(version) + ": " + path);
+            return false;
+        }
+
+        // Checkpoints and ranks are rebuilt; only the BWT and samples are stored
+        const uint64_t maxRows = MAX_TEXT_LENGTH + 1;
+        bool ok = readVector(file, bwt_, maxRows) &&
+            readVector(file, sampledRows_, (maxRows + 31) / 32) &&
+            readVector(file, samples_, maxRows);
+
+        sentinelRow_ = static_cast<size_t>(header[0]);
+        sampleRate_ = static_cast<uint32_t>(header[1]);
+        checksum_ = header[2];
+
+        if (!ok || bwt_.empty() || sentinelRow_ >= bwt_.size() || sampleRate_ == 0 ||
+            sampledRows_.size() != (bwt_.size() + 31) / 32) {
+            clear();
+            errors_.push_back("Truncated or corrupt FM-index: " + path);
+            return false;
+        }
+
+        buildOccurrences();
+        size_t lastWord = sampledRows_.size() - 1;
+        uint32_t lastBits = sampledRows_[lastWord];
+        size_t sampled = sampledRank_[lastWord];
+        while (lastBits != 0) {
+            lastBits &= lastBits - 1;
+            sampled++;
+        }
+        if (symbolCount_ != header[3] || sampled != samples_.size()) {
+            clear();
+            errors_.push_back("Truncated or corrupt FM-index: " + path);
+            return false;
+        }
+        return true;
+    }
+
+} // namespace DNACore
\ No newline at end of file
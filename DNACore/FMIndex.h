@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace DNACore {
+
+    /**
+     * FM-index for repeated exact-pattern queries over one sequence
+     * The suffix array is built in linear time with SA-IS, turned into the
+     * BWT and then dropped, keeping only every sampleRate-th text position.
+     * Occurrence counts are checkpointed every OCC_BLOCK rows, so
+     *   count()  costs O(m) rank queries, independent of the text length;
+     *   locate() adds at most sampleRate LF steps per occurrence.
+     * Any byte values may occur in the text; sequences up to 2^31 - 2
+     * bases are supported.
+     *
+     * Memory: the BWT (1 byte/base) plus 4 * sigma / OCC_BLOCK bytes/base
+     * of checkpoints plus 4 / sampleRate bytes/base of samples. For DNA
+     * with the default rate that is about 1.5 bytes/base.
+     */
+    class FMIndex {
+    public:
+        // Rows between occurrence checkpoints
+        static constexpr size_t OCC_BLOCK = 64;
+
+        static constexpr uint32_t DEFAULT_SAMPLE_RATE = 32;
+
+        FMIndex();
+        ~FMIndex();
+
+        /**
+         * Index a sequence, replacing any previous index
+         * @param sampleRate Keep the suffix array entry of every
+         *        sampleRate-th text position (>= 1)
+         * @return false if the sequence is too long; see getErrors()
+         */
+        bool build(const char* text, size_t length, uint32_t sampleRate = DEFAULT_SAMPLE_RATE);
+
+        bool build(const std::string& text, uint32_t sampleRate = DEFAULT_SAMPLE_RATE) {
+            return build(text.data(), text.length(), sampleRate);
+        }
+
+        /**
+         * Read an index written by save()
+         */
+        bool load(const std::string& path);
+
+        /**
+         * Write the index in a binary format (native byte order)
+         */
+        bool save(const std::string& path) const;
+
+        void clear();
+
+        bool empty() const { return bwt_.empty(); }
+
+        /**
+         * Length of the indexed sequence
+         */
+        size_t textLength() const { return bwt_.empty() ? 0 : bwt_.size() - 1; }
+
+        /**
+         * Fingerprint of the indexed sequence (see checksumOf)
+         */
+        uint64_t checksum() const { return checksum_; }
+
+        /**
+         * 64-bit FNV-1a hash, used to match a saved index to its sequence
+         */
+        static uint64_t checksumOf(const char* text, size_t length);
+
+        uint32_t sampleRate() const { return sampleRate_; }
+
+        /**
+         * Bytes held by the index
+         */
+        size_t memoryUsage() const;
+
+        // ===== QUERIES =====
+
+        /**
+         * Number of (possibly overlapping) occurrences of a pattern
+         */
+        size_t count(const std::string& pattern) const;
+
+        /**
+         * Start positions of every occurrence, in ascending order
+         */
+        std::vector<size_t> locate(const std::string& pattern) const;
+
+        const std::vector<std::string>& getErrors() const { return errors_; }
+
+    private:
+        std::vector<unsigned char> bwt_;      // Sentinel row holds 0 (see sentinelRow_)
+        std::vector<uint32_t> occ_;           // Per block: count of each symbol before it
+        std::vector<uint32_t> sampledRows_;   // Bit per row: row has a suffix array sample
+        std::vector<uint32_t> sampledRank_;   // Samples before each 32-row word
+        std::vector<uint32_t> samples_;       // Suffix array values of sampled rows, in row order
+        std::vector<size_t> firstRow_;        // C array: first row starting with each byte
+        std::vector<int> slot_;               // Byte -> checkpoint column, -1 if absent
+        size_t symbolCount_;
+        size_t sentinelRow_;
+        uint32_t sampleRate_;
+        uint64_t checksum_;
+        std::vector<std::string> errors_;
+
+        /**
+         * Rows [begin, end) whose suffixes start with the pattern
+         */
+        void backwardSearch(const std::string& pattern, size_t& begin, size_t& end) const;
+
+        /**
+         * Occurrences of byte c in bwt_[0, row)
+         */
+        size_t rank(unsigned char c, size_t row) const;
+
+        /**
+         * Text position of the suffix in a row, walking LF to a sample
+         */
+        size_t textPosition(size_t row) const;
+
+        bool isSampled(size_t row) const {
+            return (sampledRows_[row / 32] >> (row % 32)) & 1u;
+        }
+
+        /**
+         * Fill occ_, firstRow_ and slot_ from bwt_
+         */
+        void buildOccurrences();
+    };
+
+} // namespace DNACore
\ No newline at end of file
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+namespace DNACore {
+
+    namespace detail {
+
+        /**
+         * Byte -> set of bases it stands for (A = 1, C = 2, G = 4, T/U = 8),
+         * 0 for bytes that are not uppercase IUPAC nucleotide codes
+         */
+        constexpr std::array<unsigned char, 256> makeBaseMaskTable() {
+            std::array<unsigned char, 256> table{};
+            table['A'] = 1;
+            table['C'] = 2;
+            table['G'] = 4;
+            table['T'] = 8;
+            table['U'] = 8;
+            table['R'] = 1 | 4;
+            table['Y'] = 2 | 8;
+            table['S'] = 2 | 4;
+            table['W'] = 1 | 8;
+            table['K'] = 4 | 8;
+            table['M'] = 1 | 2;
+            table['B'] = 2 | 4 | 8;
+            table['D'] = 1 | 4 | 8;
+            table['H'] = 1 | 2 | 8;
+            table['V'] = 1 | 2 | 4;
+            table['N'] = 1 | 2 | 4 | 8;
+            return table;
+        }
+
+        /**
+         * Byte -> complementary code (R <-> Y, K <-> M, B <-> V, D <-> H;
+         * S, W and N are their own complements, U pairs with A); other
+         * bytes map to themselves
+         */
+        constexpr std::array<char, 256> makeCodeComplementTable() {
+            std::array<char, 256> table{};
+            for (int byte = 0; byte < 256; ++byte) {
+                table[byte] = static_cast<char>(byte);
+            }
+            const char pairs[][2] = {
+                { 'A', 'T' }, { 'C', 'G' }, { 'R', 'Y' }, { 'K', 'M' }, { 'B', 'V' }, { 'D', 'H' }
+            };
+            for (const auto& pair : pairs) {
+                table[static_cast<unsigned char>(pair[0])] = pair[1];
+                table[static_cast<unsigned char>(pair[1])] = pair[0];
+            }
+            table['U'] = 'A';
+            return table;
+        }
+
+    } // namespace detail
+
+    /**
+     * IUPAC nucleotide codes in search patterns
+     * A degenerate code (R, Y, S, W, K, M, B, D, H, V, N) matches any
+     * concrete base it stands for: A, C, G, T or U, with U counting as T.
+     * Every pattern byte also matches the identical text byte, so N finds
+     * N runs and R finds R. Other ambiguous text bases never match a
+     * degenerate code, since the base they hide is unknown. Patterns
+     * without degenerate codes behave exactly as before.
+     */
+    class IUPACCode {
+    public:
+        static constexpr std::array<unsigned char, 256> BASE_MASK = detail::makeBaseMaskTable();
+        static constexpr std::array<char, 256> COMPLEMENT = detail::makeCodeComplementTable();
+
+        /**
+         * Bases a code stands for (0 if it is not a nucleotide code)
+         */
+        static unsigned baseMask(char code) {
+            return BASE_MASK[static_cast<unsigned char>(code)];
+        }
+
+        /**
+         * Check for A, C, G, T or U
+         */
+        static bool isConcrete(char base) {
+            unsigned mask = baseMask(base);
+            return mask != 0 && (mask & (mask - 1)) == 0;
+        }
+
+        /**
+         * Check for a code standing for two or more bases
+         */
+        static bool isDegenerate(char code) {
+            unsigned mask = baseMask(code);
+            return (mask & (mask - 1)) != 0;
+        }
+
+        /**
+         * Check whether a pattern contains any degenerate code
+         */
+        static bool isDegenerate(const std::string& pattern) {
+            for (char ch : pattern) {
+                if (isDegenerate(ch)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * Pattern read on the opposite strand: complemented codes in
+         * reverse order (TATAWAWR -> YWTWTATA)
+         */
+        static std::string reverseComplement(const std::string& pattern) {
+            std::string result(pattern.rbegin(), pattern.rend());
+            for (char& ch : result) {
+                ch = COMPLEMENT[static_cast<unsigned char>(ch)];
+            }
+            return result;
+        }
+
+        /**
+         * Check whether a pattern reads the same on both strands (GAATTC)
+         */
+        static bool isPalindrome(const std::string& pattern) {
+            return pattern == reverseComplement(pattern);
+        }
+
+        /**
+         * Check whether a text byte matches a pattern byte
+         */
+        static bool matches(char patternCode, char textBase) {
+            if (patternCode == textBase) {
+                return true;
+            }
+            if (!isDegenerate(patternCode)) {
+                return false;
+            }
+            return isConcrete(textBase) && (baseMask(textBase) & baseMask(patternCode)) != 0;
+        }
+    };
+
+} // namespace DNACore
\ No newline at end of file
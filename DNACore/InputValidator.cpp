@@ -1,4 +1,6 @@
 #include "InputValidator.h"
+#include "CompositionKernel.h"
+#include <cstring>
 
 namespace DNACore {
 
@@ -24,40 +26,25 @@ namespace DNACore {
             return result;
         }
 
-        // Check for lowercase letters BEFORE cleaning (if autoUppercase is disabled)
-        if (!config_.autoUppercase) {
-            for (char c : sequence) {
-                if (std::isalpha(static_cast<unsigned char>(c)) && std::islower(static_cast<unsigned char>(c))) {
-                    result.isValid = false;
-                    result.errors.push_back("Lowercase letters are not allowed. Please use uppercase nucleotides only (A, T, G, C, U, N)");
-                    return result;
-                }
-            }
+        // Clean a copy; a rejected sequence reports no cleaned bases
+        result.cleanedSequence = sequence;
+        if (!cleanAndValidate(result.cleanedSequence, true, result)) {
+            result.cleanedSequence.clear();
         }
 
-        // Clean and validate
-        result.cleanedSequence = cleanSequence(sequence, result);
+        return result;
+    }
 
-        // Check length constraints
-        if (result.cleanedSequence.length() < config_.minLength) {
-            result.isValid = false;
-            result.errors.push_back(
-                "Sequence too short: " + std::to_string(result.cleanedSequence.length()) +
-                " bp (minimum: " + std::to_string(config_.minLength) + ")"
-            );
-        }
+    ValidationResult InputValidator::validateInPlace(std::string& sequence) const {
+        ValidationResult result;
 
-        if (config_.maxLength > 0 && result.cleanedSequence.length() > config_.maxLength) {
+        if (sequence.empty()) {
             result.isValid = false;
-            result.errors.push_back(
-                "Sequence too long: " + std::to_string(result.cleanedSequence.length()) +
-                " bp (maximum: " + std::to_string(config_.maxLength) + ")"
-            );
+            result.errors.push_back("Sequence is empty");
+            return result;
         }
 
-        // Validate characters
-        validateCharacters(result.cleanedSequence, result);
-
+        cleanAndValidate(sequence, true, result);
         return result;
     }
 
@@ -76,90 +63,135 @@ namespace DNACore {
             return result;
         }
 
-        // Check for lowercase letters BEFORE cleaning (if autoUppercase is disabled)
-        if (!config_.autoUppercase) {
-            for (char c : pattern) {
-                if (std::isalpha(static_cast<unsigned char>(c)) && std::islower(static_cast<unsigned char>(c))) {
-                    result.isValid = false;
-                    result.errors.push_back("Lowercase letters are not allowed. Please use uppercase nucleotides only (A, T, G, C, U, N)");
-                    return result;
-                }
-            }
+        result.cleanedSequence = pattern;
+        if (!cleanAndValidate(result.cleanedSequence, false, result)) {
+            result.cleanedSequence.clear();
         }
 
-        result.cleanedSequence = cleanSequence(pattern, result);
-        validateCharacters(result.cleanedSequence, result);
-
         return result;
     }
 
-    std::string InputValidator::cleanSequence(const std::string& seq, ValidationResult& result) const {
-        std::string cleaned;
-        cleaned.reserve(seq.length());
+    InputValidator::ByteTable InputValidator::buildTable() const {
+        ByteTable table;
 
-        for (char c : seq) {
-            // Skip whitespace if allowed
-            if (config_.allowWhitespace && std::isspace(static_cast<unsigned char>(c))) {
-                continue;
+        for (int byte = 0; byte < 256; ++byte) {
+            char ch = static_cast<char>(byte);
+            unsigned char action = ACTION_INVALID;
+
+            if (config_.allowWhitespace && std::isspace(byte)) {
+                action = ACTION_SKIP;
+            }
+            else if (byte >= 'a' && byte <= 'z' && !config_.autoUppercase) {
+                action = ACTION_REJECT;
             }
+            else {
+                // DO NOT convert to uppercase unless explicitly enabled
+                if (config_.autoUppercase) {
+                    ch = static_cast<char>(std::toupper(byte));
+                }
 
-            // DO NOT convert to uppercase - keep original case so validation can catch it
-            // Only uppercase if explicitly enabled AND we want auto-conversion
-            char ch = c;  // Keep original character
-            if (config_.autoUppercase) {
-                ch = std::toupper(static_cast<unsigned char>(c));
+                if (VALID_NUCLEOTIDES.find(ch) != std::string::npos) {
+                    action = ACTION_BASE;
+                }
+                else if (AMBIGUITY_CODES.find(ch) != std::string::npos) {
+                    action = ACTION_AMBIGUOUS;
+                }
             }
 
-            cleaned += ch;
+            table.action[byte] = action;
+            table.output[byte] = ch;
         }
 
-        return cleaned;
+        return table;
     }
 
-    void InputValidator::validateCharacters(const std::string& seq, ValidationResult& result) const {
+    bool InputValidator::cleanAndValidate(std::string& seq, bool checkLength, ValidationResult& result) const {
+        const ByteTable table = buildTable();
+
+        char* data = &seq[0];
+        const size_t length = seq.length();
+        size_t read = 0;
+        size_t written = 0;
+
         size_t invalidCount = 0;
         size_t ambiguousCount = 0;
         std::string invalidChars;
+        bool reported[256] = {};
 
-        // HARDCODED: Explicitly check for lowercase and reject it
-        for (size_t i = 0; i < seq.length(); ++i) {
-            char c = seq[i];
-
-            // Reject any lowercase letter immediately
-            if (c >= 'a' && c <= 'z') {
-                result.isValid = false;
-                result.errors.push_back("Lowercase letters are not allowed. Use uppercase only (A, T, G, C, U, N)");
-                return;
+        auto reportChar = [&](char c) {
+            unsigned char key = static_cast<unsigned char>(c);
+            if (!reported[key]) {
+                reported[key] = true;
+                invalidChars += c;
             }
-        }
-
-        // Now validate the actual content
-        for (size_t i = 0; i < seq.length(); ++i) {
-            char c = seq[i];
-
-            // Check if standard nucleotide
-            if (VALID_NUCLEOTIDES.find(c) != std::string::npos) {
+        };
+
+        while (read < length) {
+            // Fast path: runs of plain A, C, G, T, U are kept as they are
+            size_t run = CompositionKernel::nucleotideRun(data + read, length - read);
+            if (run > 0) {
+                if (written != read) {
+                    std::memmove(data + written, data + read, run);
+                }
+                read += run;
+                written += run;
                 continue;
             }
 
-            // Check if ambiguous code
-            if (AMBIGUITY_CODES.find(c) != std::string::npos) {
-                ambiguousCount++;
-                if (!config_.allowAmbiguous) {
-                    result.isValid = false;
-                    if (invalidChars.find(c) == std::string::npos) {
-                        invalidChars += c;
+            // Slow path: classify bytes until the next plain nucleotide
+            for (; read < length; ++read) {
+                unsigned char byte = static_cast<unsigned char>(data[read]);
+                char out = table.output[byte];
+
+                switch (table.action[byte]) {
+                case ACTION_BASE:
+                    if (out == data[read]) {
+                        break;
                     }
+                    data[written++] = out;
+                    continue;
+                case ACTION_AMBIGUOUS:
+                    ambiguousCount++;
+                    if (!config_.allowAmbiguous) {
+                        result.isValid = false;
+                        reportChar(out);
+                    }
+                    data[written++] = out;
+                    continue;
+                case ACTION_INVALID:
+                    invalidCount++;
+                    result.isValid = false;
+                    reportChar(out);
+                    data[written++] = out;
+                    continue;
+                case ACTION_SKIP:
+                    continue;
+                default:
+                    result.isValid = false;
+                    result.errors.push_back("Lowercase letters are not allowed. Please use uppercase nucleotides only (A, T, G, C, U, N)");
+                    return false;
                 }
-                continue;
+                break;
             }
+        }
+
+        seq.resize(written);
 
-            // Invalid character
-            invalidCount++;
+        // Check length constraints
+        if (checkLength && seq.length() < config_.minLength) {
             result.isValid = false;
-            if (invalidChars.find(c) == std::string::npos) {
-                invalidChars += c;
-            }
+            result.errors.push_back(
+                "Sequence too short: " + std::to_string(seq.length()) +
+                " bp (minimum: " + std::to_string(config_.minLength) + ")"
+            );
+        }
+
+        if (checkLength && config_.maxLength > 0 && seq.length() > config_.maxLength) {
+            result.isValid = false;
+            result.errors.push_back(
+                "Sequence too long: " + std::to_string(seq.length()) +
+                " bp (maximum: " + std::to_string(config_.maxLength) + ")"
+            );
         }
 
         // Report errors
@@ -187,6 +219,8 @@ namespace DNACore {
                 " bp) - some algorithms may be slow"
             );
         }
+
+        return true;
     }
 
 } // namespace DNACore
\ No newline at end of file
@@ -56,6 +56,16 @@ namespace DNACore {
          */
         ValidationResult validate(const std::string& sequence) const;
 
+        /**
+         * Validate and clean a sequence in place (no copy of the input)
+         * On return the sequence holds the cleaned bases and
+         * result.cleanedSequence is left empty. If a lowercase letter is
+         * rejected the sequence may be partially cleaned.
+         * @param sequence The sequence to validate and clean
+         * @return ValidationResult with any errors/warnings
+         */
+        ValidationResult validateInPlace(std::string& sequence) const;
+
         /**
          * Validate a search pattern (less strict than sequence validation)
          * @param pattern The pattern to validate
@@ -84,14 +94,34 @@ namespace DNACore {
         static const std::string AMBIGUITY_CODES;
 
         /**
-         * Clean sequence (remove whitespace only - NO case conversion in strict mode)
+         * What the single validation pass does with each byte value
          */
-        std::string cleanSequence(const std::string& seq, ValidationResult& result) const;
+        enum ByteAction : unsigned char {
+            ACTION_BASE = 0,            // Standard nucleotide, kept
+            ACTION_AMBIGUOUS,           // IUPAC ambiguity code, kept and counted
+            ACTION_INVALID,             // Kept and reported
+            ACTION_SKIP,                // Whitespace, removed
+            ACTION_REJECT               // Lowercase letter without autoUppercase
+        };
+
+        /**
+         * Per-byte action and output byte for the current configuration
+         */
+        struct ByteTable {
+            unsigned char action[256];
+            char output[256];
+        };
+
+        ByteTable buildTable() const;
 
         /**
-         * Validate characters in sequence (STRICT:  reject lowercase)
+         * Clean and check a sequence in a single fused pass
+         * Whitespace is stripped, case conversion applied and ambiguous or
+         * invalid characters counted while the cleaned bases are written
+         * back into the same buffer.
+         * @return false if the pass stopped at a rejected lowercase letter
          */
-        void validateCharacters(const std::string& seq, ValidationResult& result) const;
+        bool cleanAndValidate(std::string& seq, bool checkLength, ValidationResult& result) const;
     };
 
 } // namespace DNACore
\ No newline at end of file
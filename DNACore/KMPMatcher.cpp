@@ -40,60 +40,15 @@ namespace DNACore {
     std::vector<MatchResult> KMPMatcher::search(const std::string& text, const std::string& pattern) {
         std::vector<MatchResult> results;
 
-        if (pattern.empty() || text.empty()) {
-            return results;
-        }
-
-        size_t n = text.length();
-        size_t m = pattern.length();
-
-        if (m > n) {
-            return results;
-        }
-
-        // Reset statistics
-        comparisons_ = 0;
-        shifts_ = 0;
-
-        // Preprocess pattern
-        computeLPSArray(pattern);
-
-        // Search
-        size_t i = 0;  // Index for text
-        size_t j = 0;  // Index for pattern
-
-        while (i < n) {
-            comparisons_++;
-
-            if (pattern[j] == text[i]) {
-                i++;
-                j++;
-            }
-
-            if (j == m) {
-                // Match found
-                size_t matchPos = i - j;
-                results.emplace_back(
-                    matchPos,
-                    text.substr(matchPos, m),
-                    0,           // editDistance = 0 (exact match)
-                    "Exact Match",
-                    "KMP"
-                );
-
-                j = lps_[j - 1];
-                shifts_++;
-            }
-            else if (i < n && pattern[j] != text[i]) {
-                if (j != 0) {
-                    j = lps_[j - 1];
-                    shifts_++;
-                }
-                else {
-                    i++;
-                }
-            }
-        }
+        searchEach(text, pattern, [&](size_t position, int, size_t length, int editDistance) {
+            results.emplace_back(
+                position,
+                text.substr(position, length),
+                editDistance,  // 0 (exact match)
+                "Exact Match",
+                "KMP"
+            );
+        });
 
         return results;
     }
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include "AnalysisTypes.h"
+#include "PackedSequence.h"
 
 namespace DNACore {
 
@@ -24,6 +25,63 @@ namespace DNACore {
          */
         std::vector<MatchResult> search(const std::string& text, const std::string& pattern);
 
+        /**
+         * Allocation-free search: calls sink(position, patternId, length,
+         * editDistance) for every occurrence (patternId is always 0)
+         * @return Number of occurrences delivered before the sink stopped
+         */
+        template <typename Sink>
+        size_t searchEach(const std::string& text, const std::string& pattern, Sink&& sink) {
+            if (pattern.empty() || text.empty() || pattern.length() > text.length()) {
+                return 0;
+            }
+
+            // Reset statistics
+            comparisons_ = 0;
+            shifts_ = 0;
+
+            // Preprocess pattern
+            computeLPSArray(pattern);
+
+            size_t j = 0;
+            size_t found = 0;
+            advanceEach(text.data(), text.length(), 0, pattern, j, found, sink);
+            return found;
+        }
+
+        /**
+         * Search a 2-bit packed sequence
+         * Patterns of up to PackedSequence::MAX_PACKED_PATTERN plain bases
+         * are compared in the packed domain; anything else runs KMP over
+         * decoded blocks. Same hits, in the same order, as the string search.
+         */
+        template <typename Sink>
+        size_t searchEach(const PackedSequence& text, const std::string& pattern, Sink&& sink) {
+            if (pattern.empty() || text.empty() || pattern.length() > text.size()) {
+                return 0;
+            }
+
+            comparisons_ = 0;
+            shifts_ = 0;
+
+            if (text.canSearchPacked(pattern)) {
+                lps_.clear();
+                return text.findEach(pattern, sink);
+            }
+
+            computeLPSArray(pattern);
+
+            size_t j = 0;
+            size_t found = 0;
+            size_t offset = 0;
+            text.forEachBlock([&](std::string_view block) {
+                bool keepGoing = advanceEach(block.data(), block.size(), offset, pattern, j, found, sink);
+                offset += block.size();
+                return keepGoing;
+            });
+            return found;
+        }
+
         /**
          * Get the LPS (Longest Proper Prefix which is also Suffix) array
          * Useful for debugging and trace output
@@ -46,6 +104,51 @@ namespace DNACore {
          * This is the preprocessing step of KMP
          */
         void computeLPSArray(const std::string& pattern);
+
+        /**
+         * Run KMP over one piece of text, resuming from pattern index j
+         * @param baseOffset Position of text[0] in the whole text
+         * @return false if the sink stopped the search
+         */
+        template <typename Sink>
+        bool advanceEach(const char* text, size_t n, size_t baseOffset, const std::string& pattern,
+            size_t& j, size_t& found, Sink& sink) {
+
+            const size_t m = pattern.length();
+            const int* lps = lps_.data();
+            size_t i = 0;  // Index for text
+
+            while (i < n) {
+                comparisons_++;
+
+                if (pattern[j] == text[i]) {
+                    i++;
+                    j++;
+                }
+
+                if (j == m) {
+                    // Match found
+                    found++;
+                    if (!detail::emitMatch(sink, baseOffset + i - j, 0, m, 0)) {
+                        return false;
+                    }
+
+                    j = lps[j - 1];
+                    shifts_++;
+                }
+                else if (i < n && pattern[j] != text[i]) {
+                    if (j != 0) {
+                        j = lps[j - 1];
+                        shifts_++;
+                    }
+                    else {
+                        i++;
+                    }
+                }
+            }
+
+            return true;
+        }
     };
 
 } // namespace DNACore
\ No newline at end of file
@@ -0,0 +1,247 @@
+#include "MappedFASTA.h"
+#include <cstring>
+
+namespace DNACore {
+
+    namespace {
+
+        inline bool isLineSpace(char c) {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+    } // namespace
+
+    MappedFASTA::MappedFASTA()
+        : compactMutex_(std::make_unique<std::mutex>()) {
+    }
+
+    MappedFASTA::~MappedFASTA() {
+    }
+
+    bool MappedFASTA::open(const std::string& filepath) {
+        close();
+
+        std::string error;
+        if (!file_.open(filepath, error)) {
+            errors_.push_back(error);
+            return false;
+        }
+
+        if (file_.size() == 0) {
+            errors_.push_back("File is empty");
+            file_.close();
+            return false;
+        }
+
+        indexRecords();
+
+        if (records_.empty()) {
+            errors_.push_back("No valid sequences found");
+            file_.close();
+            return false;
+        }
+
+        compacted_.resize(records_.size());
+        return true;
+    }
+
+    void MappedFASTA::close() {
+        file_.close();
+        records_.clear();
+        errors_.clear();
+        warnings_.clear();
+        compacted_.clear();
+        if (!compactMutex_) {
+            compactMutex_ = std::make_unique<std::mutex>();
+        }
+    }
+
+    void MappedFASTA::indexRecords() {
+        const char* data = file_.data();
+        const size_t size = file_.size();
+        size_t pos = 0;
+
+        // Plain sequence file: a single unnamed record
+        if (data[0] != '>') {
+            FASTARecordView record;
+            record.header = "Unnamed Sequence";
+            record.description = "Plain Text Input";
+            pos = indexSequence(record, 0);
+            records_.push_back(std::move(record));
+        }
+
+        while (pos < size) {
+            // pos is at a '>' that starts a line
+            const char* newline = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+            size_t lineEnd = newline != nullptr ? static_cast<size_t>(newline - data) : size;
+
+            size_t headerEnd = lineEnd;
+            while (headerEnd > pos + 1 && (isLineSpace(data[headerEnd - 1]) || data[headerEnd - 1] == '\n')) {
+                headerEnd--;
+            }
+
+            FASTARecordView record;
+            record.header = std::string_view(data + pos + 1, headerEnd - pos - 1);
+            record.description = record.header.substr(0, record.header.find_first_of(" \t"));
+
+            pos = newline != nullptr ? lineEnd + 1 : size;
+            pos = indexSequence(record, pos);
+
+            if (!record.isUniform()) {
+                warnings_.push_back(
+                    std::string(record.description) + ": irregular line lengths, using a line table"
+                );
+            }
+
+            records_.push_back(std::move(record));
+        }
+    }
+
+    size_t MappedFASTA::indexSequence(FASTARecordView& record, size_t pos) const {
+        const char* data = file_.data();
+        const size_t size = file_.size();
+        const size_t start = pos;
+
+        size_t lineBases = 0;
+        size_t lineWidth = 0;
+        bool ended = false;       // A short or blank line was seen; no more bases allowed
+
+        record.offset = start;
+        record.length = 0;
+
+        while (pos < size && data[pos] != '>') {
+            const char* newline = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+            size_t lineEnd = newline != nullptr ? static_cast<size_t>(newline - data) : size;
+            size_t next = newline != nullptr ? lineEnd + 1 : size;
+
+            size_t end = lineEnd;
+            while (end > pos && isLineSpace(data[end - 1])) {
+                end--;
+            }
+            size_t bases = end - pos;
+
+            if (bases == 0) {
+                ended = true;
+            }
+            else if (ended || isLineSpace(data[pos])) {
+                // Bases after a short/blank line, or indented lines
+                return buildLineTable(record, start);
+            }
+            else if (lineBases == 0) {
+                lineBases = bases;
+                lineWidth = next - pos;
+            }
+            else if (bases != lineBases || next - pos != lineWidth) {
+                if (bases > lineBases) {
+                    return buildLineTable(record, start);
+                }
+                ended = true;     // Only valid as the last line
+            }
+
+            record.length += bases;
+            pos = next;
+        }
+
+        record.lineBases = lineBases;
+        record.lineWidth = lineWidth;
+        return pos;
+    }
+
+    size_t MappedFASTA::buildLineTable(FASTARecordView& record, size_t pos) const {
+        const char* data = file_.data();
+        const size_t size = file_.size();
+
+        record.length = 0;
+        record.lineBases = 0;
+        record.lineWidth = 0;
+        record.lines.clear();
+
+        while (pos < size && data[pos] != '>') {
+            const char* newline = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+            size_t lineEnd = newline != nullptr ? static_cast<size_t>(newline - data) : size;
+
+            size_t begin = pos;
+            size_t end = lineEnd;
+            while (begin < end && isLineSpace(data[begin])) {
+                begin++;
+            }
+            while (end > begin && isLineSpace(data[end - 1])) {
+                end--;
+            }
+
+            if (end > begin) {
+                record.lines.push_back({ begin, record.length, end - begin });
+                record.length += end - begin;
+            }
+
+            pos = newline != nullptr ? lineEnd + 1 : size;
+        }
+
+        record.offset = record.lines.empty() ? pos : record.lines.front().fileOffset;
+        return pos;
+    }
+
+    size_t MappedFASTA::findLine(const FASTARecordView& record, size_t position) {
+        auto it = std::upper_bound(record.lines.begin(), record.lines.end(), position,
+            [](size_t value, const FASTALineSpan& span) { return value < span.start; });
+        return static_cast<size_t>(it - record.lines.begin()) - 1;
+    }
+
+    const FASTARecordView* MappedFASTA::find(std::string_view name) const {
+        for (const auto& record : records_) {
+            if (record.description == name) {
+                return &record;
+            }
+        }
+        return nullptr;
+    }
+
+    char MappedFASTA::baseAt(const FASTARecordView& record, size_t position) const {
+        const char* data = file_.data();
+
+        if (record.isUniform()) {
+            return data[record.offset + (position / record.lineBases) * record.lineWidth +
+                position % record.lineBases];
+        }
+
+        const FASTALineSpan& span = record.lines[findLine(record, position)];
+        return data[span.fileOffset + position - span.start];
+    }
+
+    std::string MappedFASTA::extract(const FASTARecordView& record, size_t position, size_t length) const {
+        std::string result;
+        if (position < record.length) {
+            result.reserve(std::min(length, record.length - position));
+        }
+
+        forEachSpan(record, position, length, [&result](std::string_view piece) {
+            result.append(piece.data(), piece.size());
+            return true;
+        });
+
+        return result;
+    }
+
+    std::string_view MappedFASTA::sequence(size_t index) const {
+        const FASTARecordView& record = records_[index];
+
+        if (record.length == 0) {
+            return std::string_view();
+        }
+
+        // Single-line records are already contiguous in the mapping
+        if (record.isUniform() && record.length <= record.lineBases) {
+            return std::string_view(file_.data() + record.offset, record.length);
+        }
+        if (record.lines.size() == 1) {
+            return std::string_view(file_.data() + record.lines[0].fileOffset, record.length);
+        }
+
+        std::lock_guard<std::mutex> lock(*compactMutex_);
+        if (!compacted_[index]) {
+            compacted_[index] = std::make_unique<std::string>(extract(record, 0, record.length));
+        }
+        return *compacted_[index];
+    }
+
+} // namespace DNACore
\ No newline at end of file
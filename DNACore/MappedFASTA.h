@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include "MappedFile.h"
+
+namespace DNACore {
+
+    /**
+     * One sequence line of an irregular record
+     */
+    struct FASTALineSpan {
+        size_t fileOffset;        // Offset of the line's first base in the file
+        size_t start;             // Index of that base within the record
+        size_t length;            // Bases on the line
+    };
+
+    /**
+     * Zero-copy view of one FASTA record inside a mapped file
+     * Uniform records (every line but the last has lineBases bases and
+     * lineWidth bytes) need no line table: base i lives at
+     * offset + (i / lineBases) * lineWidth + i % lineBases. Other records
+     * keep one FASTALineSpan per non-empty line.
+     */
+    struct FASTARecordView {
+        std::string_view header;       // Everything after '>'
+        std::string_view description;  // First part of header (ID)
+        size_t length;                 // Number of bases
+        size_t offset;                 // File offset of the first base
+        size_t lineBases;              // Bases per full line
+        size_t lineWidth;              // Bytes per full line, including the terminator
+        std::vector<FASTALineSpan> lines;  // Empty for uniform records
+
+        FASTARecordView() : length(0), offset(0), lineBases(0), lineWidth(0) {}
+
+        bool isUniform() const { return lines.empty(); }
+        bool isEmpty() const { return length == 0; }
+    };
+
+    /**
+     * Memory-mapped FASTA file with records exposed as views
+     * Opening maps the file and finds headers and line breaks with memchr;
+     * no sequence data is copied (only sequence() of a multi-line record
+     * copies, see below). Bases are returned exactly as stored
+     * (no validation or case folding), so run InputValidator on extracted
+     * ranges when needed. Views stay valid until close() or destruction.
+     */
+    class MappedFASTA {
+    public:
+        MappedFASTA();
+        ~MappedFASTA();
+
+        MappedFASTA(MappedFASTA&&) = default;
+        MappedFASTA& operator=(MappedFASTA&&) = default;
+
+        /**
+         * Map and index a FASTA (or plain sequence) file
+         * @return false on failure; see getErrors()
+         */
+        bool open(const std::string& filepath);
+
+        /**
+         * Unmap the file and drop all records
+         */
+        void close();
+
+        bool isOpen() const { return file_.isOpen(); }
+
+        size_t recordCount() const { return records_.size(); }
+
+        const FASTARecordView& record(size_t index) const { return records_[index]; }
+
+        const std::vector<FASTARecordView>& records() const { return records_; }
+
+        /**
+         * Find a record by description (first word of the header)
+         * @return nullptr if no record has that name
+         */
+        const FASTARecordView* find(std::string_view name) const;
+
+        /**
+         * Get one base of a record
+         */
+        char baseAt(const FASTARecordView& record, size_t position) const;
+
+        /**
+         * Visit the contiguous pieces covering [position, position + length)
+         * of a record, calling visit(std::string_view) for each in order.
+         * The range is clipped to the record.
+         * @return false if the visitor returned false
+         */
+        template <typename Visitor>
+        bool forEachSpan(const FASTARecordView& record, size_t position, size_t length,
+            Visitor&& visit) const {
+
+            if (position >= record.length) {
+                return true;
+            }
+            size_t remaining = std::min(length, record.length - position);
+            const char* base = file_.data();
+
+            if (record.isUniform()) {
+                size_t line = position / record.lineBases;
+                size_t column = position % record.lineBases;
+                while (remaining > 0) {
+                    size_t take = std::min(remaining, record.lineBases - column);
+                    if (!visit(std::string_view(base + record.offset + line * record.lineWidth + column, take))) {
+                        return false;
+                    }
+                    remaining -= take;
+                    line++;
+                    column = 0;
+                }
+                return true;
+            }
+
+            for (size_t i = findLine(record, position); remaining > 0; ++i) {
+                const FASTALineSpan& span = record.lines[i];
+                size_t column = position - span.start;
+                size_t take = std::min(remaining, span.length - column);
+                if (!visit(std::string_view(base + span.fileOffset + column, take))) {
+                    return false;
+                }
+                remaining -= take;
+                position += take;
+            }
+            return true;
+        }
+
+        /**
+         * Copy [position, position + length) of a record (clipped)
+         */
+        std::string extract(const FASTARecordView& record, size_t position, size_t length) const;
+
+        /**
+         * Whole sequence of a record as one contiguous view
+         * Single-line records point straight into the mapping. Multi-line
+         * records are copied into a heap string on first use and the copy
+         * is kept until close(), so calling this for every record of a
+         * large file holds the whole genome in memory a second time.
+         * Prefer forEachSpan() to stream a record, or extract() for a
+         * task-local copy that is freed when the caller is done with it.
+         * Thread-safe.
+         */
+        std::string_view sequence(size_t index) const;
+
+        /**
+         * The mapped file contents
+         */
+        std::string_view data() const { return file_.view(); }
+
+        const std::vector<std::string>& getErrors() const { return errors_; }
+        const std::vector<std::string>& getWarnings() const { return warnings_; }
+
+    private:
+        MappedFile file_;
+        std::vector<FASTARecordView> records_;
+        std::vector<std::string> errors_;
+        std::vector<std::string> warnings_;
+
+        // Lazily compacted multi-line sequences, one slot per record
+        mutable std::vector<std::unique_ptr<std::string>> compacted_;
+        mutable std::unique_ptr<std::mutex> compactMutex_;
+
+        /**
+         * Index records and their line layout
+         */
+        void indexRecords();
+
+        /**
+         * Scan the sequence lines of a record starting at pos
+         * @return Offset of the next header (or end of file)
+         */
+        size_t indexSequence(FASTARecordView& record, size_t pos) const;
+
+        /**
+         * Build the line table of an irregular record from scratch
+         * @return Offset where the record's sequence lines end
+         */
+        size_t buildLineTable(FASTARecordView& record, size_t pos) const;
+
+        /**
+         * Index of the line span containing a base (irregular records)
+         */
+        static size_t findLine(const FASTARecordView& record, size_t position);
+    };
+
+} // namespace DNACore
\ No newline at end of file
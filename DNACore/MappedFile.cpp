@@ -0,0 +1,177 @@
+#include "MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace DNACore {
+
+    MappedFile::MappedFile()
+        : data_(nullptr), size_(0), isOpen_(false)
+#ifdef _WIN32
+        , fileHandle_(nullptr), mappingHandle_(nullptr)
+#endif
+    {
+    }
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : MappedFile() {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+
+            data_ = other.data_;
+            size_ = other.size_;
+            isOpen_ = other.isOpen_;
+#ifdef _WIN32
+            fileHandle_ = other.fileHandle_;
+            mappingHandle_ = other.mappingHandle_;
+            other.fileHandle_ = nullptr;
+            other.mappingHandle_ = nullptr;
+#endif
+            other.data_ = nullptr;
+            other.size_ = 0;
+            other.isOpen_ = false;
+        }
+        return *this;
+    }
+
+#ifdef _WIN32
+
+    bool MappedFile::open(const std::string& filepath, std::string& error) {
+        close();
+
+        HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            error = "Failed to open file: " + filepath;
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            error = "Failed to get file size: " + filepath;
+            return false;
+        }
+
+        fileHandle_ = file;
+        size_ = static_cast<size_t>(fileSize.QuadPart);
+        isOpen_ = true;
+
+        // Zero-length files cannot be mapped; expose an empty view instead
+        if (size_ == 0) {
+            return true;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            close();
+            error = "Failed to map file: " + filepath;
+            return false;
+        }
+        mappingHandle_ = mapping;
+
+        data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (data_ == nullptr) {
+            close();
+            error = "Failed to map file: " + filepath;
+            return false;
+        }
+
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (data_ != nullptr) {
+            UnmapViewOfFile(data_);
+        }
+        if (mappingHandle_ != nullptr) {
+            CloseHandle(static_cast<HANDLE>(mappingHandle_));
+        }
+        if (fileHandle_ != nullptr) {
+            CloseHandle(static_cast<HANDLE>(fileHandle_));
+        }
+
+        data_ = nullptr;
+        size_ = 0;
+        isOpen_ = false;
+        fileHandle_ = nullptr;
+        mappingHandle_ = nullptr;
+    }
+
+#else
+
+    bool MappedFile::open(const std::string& filepath, std::string& error) {
+        close();
+
+        int fd = ::open(filepath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            error = "Failed to open file: " + filepath;
+            return false;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            error = "Failed to get file size: " + filepath;
+            return false;
+        }
+
+        size_ = static_cast<size_t>(info.st_size);
+        isOpen_ = true;
+
+        // Zero-length files cannot be mapped; expose an empty view instead
+        if (size_ == 0) {
+            ::close(fd);
+            return true;
+        }
+
+        void* address = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);  // The mapping keeps its own reference
+
+        if (address == MAP_FAILED) {
+            size_ = 0;
+            isOpen_ = false;
+            error = "Failed to map file: " + filepath + " (" + std::strerror(errno) + ")";
+            return false;
+        }
+
+        data_ = static_cast<const char*>(address);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (data_ != nullptr) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+
+        data_ = nullptr;
+        size_ = 0;
+        isOpen_ = false;
+    }
+
+#endif
+
+} // namespace DNACore
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace DNACore {
+
+    /**
+     * Read-only memory mapping of a whole file
+     * Uses mmap on POSIX and CreateFileMapping/MapViewOfFile on Windows.
+     * Pages are loaded on first access, so opening is O(1) in file size.
+     * Moving the mapping keeps its address, so views into it stay valid.
+     */
+    class MappedFile {
+    public:
+        MappedFile();
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        /**
+         * Map a file, replacing any previous mapping
+         * @param filepath Path of the file to map
+         * @param error Receives a message on failure
+         * @return true on success (an empty file maps to an empty view)
+         */
+        bool open(const std::string& filepath, std::string& error);
+
+        /**
+         * Unmap the file
+         */
+        void close();
+
+        bool isOpen() const { return isOpen_; }
+        const char* data() const { return data_; }
+        size_t size() const { return size_; }
+        std::string_view view() const { return std::string_view(data_, size_); }
+
+    private:
+        const char* data_;
+        size_t size_;
+        bool isOpen_;
+
+#ifdef _WIN32
+        void* fileHandle_;
+        void* mappingHandle_;
+#endif
+    };
+
+} // namespace DNACore
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "MotifAutomatonCache.h"
+
+namespace DNACore {
+
+    // Static member definitions
+    std::mutex MotifAutomatonCache::mutex_;
+    std::unordered_map<std::string, MotifAutomatonCache::AutomatonPtr> MotifAutomatonCache::bySet_;
+    std::unordered_map<int, MotifAutomatonCache::AutomatonPtr> MotifAutomatonCache::byType_;
+    MotifAutomatonCache::AutomatonPtr MotifAutomatonCache::allMotifs_[2];
+    size_t MotifAutomatonCache::generation_ = 0;
+
+    std::string MotifAutomatonCache::makeKey(const std::vector<MotifDatabase::MotifEntry>& motifs,
+        bool bothStrands) {
+
+        std::string key(1, bothStrands ? '2' : '1');
+        for (const auto& motif : motifs) {
+            key += motif.name;
+            key += '\x1f';
+            key += motif.pattern;
+            key += '\x1e';
+        }
+        return key;
+    }
+
+    MotifAutomatonCache::AutomatonPtr MotifAutomatonCache::build(
+        const std::vector<MotifDatabase::MotifEntry>& motifs, bool bothStrands) {
+
+        auto automaton = std::make_shared<AhoCorasick>();
+
+        for (const auto& motif : motifs) {
+            if (motif.pattern.empty()) {
+                continue;
+            }
+            if (bothStrands) {
+                automaton->addBothStrands(motif.pattern, motif.name);
+            }
+            else {
+                automaton->addPattern(motif.pattern, motif.name);
+            }
+        }
+
+        automaton->buildAutomaton();
+        return automaton;
+    }
+
+    MotifAutomatonCache::AutomatonPtr MotifAutomatonCache::get(
+        const std::vector<MotifDatabase::MotifEntry>& motifs, bool bothStrands) {
+
+        std::string key = makeKey(motifs, bothStrands);
+        size_t generation;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = bySet_.find(key);
+            if (it != bySet_.end()) {
+                return it->second;
+            }
+            generation = generation_;
+        }
+
+        // Build outside the lock; if another thread won the race, use theirs
+        AutomatonPtr automaton = build(motifs, bothStrands);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation != generation_) {
+            return automaton;  // Invalidated meanwhile: hand out, don't cache
+        }
+        return bySet_.emplace(std::move(key), std::move(automaton)).first->second;
+    }
+
+    MotifAutomatonCache::AutomatonPtr MotifAutomatonCache::getAllMotifs(bool bothStrands) {
+        AutomatonPtr& slot = allMotifs_[bothStrands ? 1 : 0];
+        size_t generation;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (slot) {
+                return slot;
+            }
+            generation = generation_;
+        }
+
+        AutomatonPtr automaton = get(MotifDatabase::getAllMotifs(), bothStrands);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation == generation_ && !slot) {
+            slot = automaton;
+        }
+        return automaton;
+    }
+
+    MotifAutomatonCache::AutomatonPtr MotifAutomatonCache::getMotif(MotifDatabase::MotifType type,
+        bool bothStrands) {
+
+        int key = static_cast<int>(type) * 2 + (bothStrands ? 1 : 0);
+        size_t generation;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = byType_.find(key);
+            if (it != byType_.end()) {
+                return it->second;
+            }
+            generation = generation_;
+        }
+
+        auto motif = MotifDatabase::getMotif(type);
+        if (motif.pattern.empty()) {
+            return nullptr;
+        }
+
+        AutomatonPtr automaton = get({ motif }, bothStrands);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation == generation_) {
+            byType_.emplace(key, automaton);
+        }
+        return automaton;
+    }
+
+    void MotifAutomatonCache::invalidate() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bySet_.clear();
+        byType_.clear();
+        allMotifs_[0].reset();
+        allMotifs_[1].reset();
+        generation_++;
+    }
+
+    size_t MotifAutomatonCache::size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return bySet_.size();
+    }
+
+} // namespace DNACore
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "AhoCorasick.h"
+#include "MotifDatabase.h"
+
+namespace DNACore {
+
+    /**
+     * Process-wide cache of compiled motif automata
+     * Automata are keyed by the motif set they were built from and handed
+     * out as shared, immutable instances, so repeated motif scans (one per
+     * FASTA record, one per analyzer) reuse the same compiled trie.
+     * Searching a cached automaton must go through AhoCorasick::scan().
+     *
+     * By default each motif is added for both strands (see
+     * AhoCorasick::addBothStrands), so one pass finds minus-strand sites;
+     * forward-only automata are cached separately.
+     */
+    class MotifAutomatonCache {
+    public:
+        using AutomatonPtr = std::shared_ptr<const AhoCorasick>;
+
+        /**
+         * Get the automaton for an arbitrary motif set, building it on first use
+         */
+        static AutomatonPtr get(const std::vector<MotifDatabase::MotifEntry>& motifs, bool bothStrands = true);
+
+        /**
+         * Get the automaton for every motif in MotifDatabase
+         */
+        static AutomatonPtr getAllMotifs(bool bothStrands = true);
+
+        /**
+         * Get the automaton for a single MotifDatabase motif
+         */
+        static AutomatonPtr getMotif(MotifDatabase::MotifType type, bool bothStrands = true);
+
+        /**
+         * Drop every cached automaton
+         * Call whenever the motif database changes; automata already handed
+         * out stay valid until their last holder releases them.
+         */
+        static void invalidate();
+
+        /**
+         * Number of cached motif sets
+         */
+        static size_t size();
+
+    private:
+        static std::mutex mutex_;
+        static std::unordered_map<std::string, AutomatonPtr> bySet_;
+        static std::unordered_map<int, AutomatonPtr> byType_;    // Keyed by type * 2 + bothStrands
+        static AutomatonPtr allMotifs_[2];                       // Indexed by bothStrands
+        static size_t generation_;               // Bumped by invalidate()
+
+        static std::string makeKey(const std::vector<MotifDatabase::MotifEntry>& motifs, bool bothStrands);
+        static AutomatonPtr build(const std::vector<MotifDatabase::MotifEntry>& motifs, bool bothStrands);
+    };
+
+} // namespace DNACore
\ No newline at end of file
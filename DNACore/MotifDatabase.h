@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <utility>
+#include "PositionWeightMatrix.h"
 
 namespace DNACore {
     /**HI SIR IPAPASAR ME 💖/
@@ -68,6 +69,21 @@ namespace DNACore {
             };
         }
 
+        /**
+         * Weight matrices for the known motifs, one per entry, built from
+         * their consensus patterns (ids are the motif type numbers)
+         * A six-base window has p-value 4^-6 at best, so the shorter motifs
+         * need a PWMScanner::Config::pValue above about 2.5e-4 to report
+         */
+        static std::vector<PositionWeightMatrix> getAllMatrices() {
+            std::vector<PositionWeightMatrix> matrices;
+            for (const auto& motif : getAllMotifs()) {
+                matrices.push_back(PositionWeightMatrix::fromConsensus(
+                    std::to_string(static_cast<int>(motif.type)), motif.name, motif.pattern));
+            }
+            return matrices;
+        }
+
         /**
          * Get motif by type
          */
@@ -0,0 +1,120 @@
+#include "MyersMatcher.h"
+#include <algorithm>
+
+namespace DNACore {
+
+    MyersMatcher::MyersMatcher()
+        : blocks_(0), columns_(0) {
+    }
+
+    MyersMatcher::~MyersMatcher() {
+    }
+
+    void MyersMatcher::preparePattern(const std::string& pattern) {
+        size_t m = pattern.length();
+
+        pattern_ = pattern;
+        blocks_ = (m + WORD_BITS - 1) / WORD_BITS;
+
+        peq_.assign(256 * blocks_, 0);
+        peqReverse_.assign(256 * blocks_, 0);
+        for (size_t i = 0; i < m; ++i) {
+            size_t reversed = m - 1 - i;
+            uint64_t bit = uint64_t(1) << (i % WORD_BITS);
+            uint64_t reversedBit = uint64_t(1) << (reversed % WORD_BITS);
+
+            if (!IUPACCode::isDegenerate(pattern[i])) {
+                size_t c = static_cast<unsigned char>(pattern[i]);
+                peq_[c * blocks_ + i / WORD_BITS] |= bit;
+                peqReverse_[c * blocks_ + reversed / WORD_BITS] |= reversedBit;
+                continue;
+            }
+
+            // A degenerate code is a class: every base it stands for matches
+            for (int c = 0; c < 256; ++c) {
+                if (IUPACCode::matches(pattern[i], static_cast<char>(c))) {
+                    peq_[c * blocks_ + i / WORD_BITS] |= bit;
+                    peqReverse_[c * blocks_ + reversed / WORD_BITS] |= reversedBit;
+                }
+            }
+        }
+
+        // Column 0: D[i][0] = i, every vertical delta is +1
+        pv_.assign(blocks_, ~uint64_t(0));
+        mv_.assign(blocks_, 0);
+
+        startPv_.resize(blocks_);
+        startMv_.resize(blocks_);
+    }
+
+    bool MyersMatcher::locateStart(const std::string& text, size_t textEnd, int maxDistance,
+        size_t& start, int& dist) {
+
+        const size_t m = pattern_.length();
+        const size_t window = std::min(m + static_cast<size_t>(maxDistance), textEnd + 1);
+        const size_t blocks = blocks_;
+        const uint64_t* peq = peqReverse_.data();
+        const uint64_t lastBit = uint64_t(1) << ((m - 1) % WORD_BITS);
+
+        uint64_t* pv = startPv_.data();
+        uint64_t* mv = startMv_.data();
+        std::fill(startPv_.begin(), startPv_.end(), ~uint64_t(0));
+        std::fill(startMv_.begin(), startMv_.end(), 0);
+
+        // Column l holds D[m][l]: the whole pattern against the last l text
+        // bases. The top row is D[0][l] = l, so +1 enters block 0 each column.
+        int score = static_cast<int>(m);
+
+        // Best distance first, then the length closest to m, then the shortest
+        size_t bestLength = 0;
+        int bestDist = maxDistance + 1;
+
+        for (size_t l = 1; l <= window; ++l) {
+            const uint64_t* eqColumn = peq +
+                static_cast<size_t>(static_cast<unsigned char>(text[textEnd + 1 - l])) * blocks;
+
+            int hin = 1;
+            for (size_t b = 0; b + 1 < blocks; ++b) {
+                hin = advanceBlock(pv[b], mv[b], eqColumn[b], hin, HIGH_BIT);
+            }
+            score += advanceBlock(pv[blocks - 1], mv[blocks - 1], eqColumn[blocks - 1], hin, lastBit);
+
+            if (score > maxDistance) {
+                continue;
+            }
+
+            size_t gap = l > m ? l - m : m - l;
+            size_t bestGap = bestLength > m ? bestLength - m : m - bestLength;
+
+            if (score < bestDist || (score == bestDist && gap < bestGap)) {
+                bestDist = score;
+                bestLength = l;
+            }
+        }
+
+        if (bestLength == 0) {
+            return false;
+        }
+
+        start = textEnd + 1 - bestLength;
+        dist = bestDist;
+        return true;
+    }
+
+    std::vector<MatchResult> MyersMatcher::search(const std::string& text, const std::string& pattern, int maxDistance) {
+        std::vector<MatchResult> results;
+
+        searchEach(text, pattern, maxDistance, [&](size_t position, int, size_t length, int dist) {
+            results.emplace_back(
+                position,
+                text.substr(position, length),
+                dist,
+                "Approx Match (dist=" + std::to_string(dist) + ")",
+                "Levenshtein"
+            );
+        });
+
+        return results;
+    }
+
+} // namespace DNACore
\ No newline at end of file
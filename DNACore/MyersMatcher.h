@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AnalysisTypes.h"
+#include "IUPACCode.h"
+
+namespace DNACore {
+
+    /**
+     * Myers' Bit-Vector Approximate String Matching
+     * Computes, for every text position, the minimal edit distance between
+     * the pattern and any substring ending there, 64 pattern rows per word.
+     * Patterns longer than 64 use multiword blocks with carried horizontal
+     * deltas. Start positions are recovered by a second bit-vector pass
+     * over the reversed pattern, reading the text backwards from the end
+     * position with the alignment anchored there.
+     * IUPAC degenerate codes in the pattern match any base they stand for.
+     * Time Complexity: O(n * ceil(m / 64)) plus O((m + k) * ceil(m / 64)) per hit
+     * Space Complexity: O(256 * ceil(m / 64)) for the match masks
+     */
+    class MyersMatcher {
+    public:
+        MyersMatcher();
+        ~MyersMatcher();
+
+        /**
+         * Find all end positions within maxDistance edits
+         * @param text The sequence to search in
+         * @param pattern The pattern to find
+         * @param maxDistance Maximum edit distance (k)
+         * @return Vector of MatchResult, one per end position, ordered by end
+         */
+        std::vector<MatchResult> search(const std::string& text, const std::string& pattern, int maxDistance);
+
+        /**
+         * Allocation-free search: calls sink(start, patternId, length,
+         * editDistance) once per end position whose minimal distance is
+         * <= maxDistance (patternId is always 0). Start and length come
+         * from the reverse pass, preferring the alignment closest to the
+         * pattern length.
+         * @return Number of hits delivered before the sink stopped
+         */
+        template <typename Sink>
+        size_t searchEach(const std::string& text, const std::string& pattern, int maxDistance, Sink&& sink) {
+            if (pattern.empty() || text.empty()) {
+                return 0;
+            }
+
+            // No alignment costs more than m edits; larger k only risks overflow
+            int k = static_cast<int>(std::min(static_cast<size_t>(std::max(maxDistance, 0)), pattern.length()));
+            preparePattern(pattern);
+
+            const size_t blocks = blocks_;
+            const uint64_t* peq = peq_.data();
+            uint64_t* pv = pv_.data();
+            uint64_t* mv = mv_.data();
+            const uint64_t lastBit = uint64_t(1) << ((pattern_.length() - 1) % WORD_BITS);
+
+            int score = static_cast<int>(pattern_.length());  // D[m][0] = m
+            size_t found = 0;
+            columns_ = 0;
+
+            for (size_t j = 0; j < text.length(); ++j) {
+                const uint64_t* eqColumn = peq + static_cast<size_t>(static_cast<unsigned char>(text[j])) * blocks;
+
+                // Free start: the top row is all zeros, so no carry into block 0
+                int hin = 0;
+                for (size_t b = 0; b + 1 < blocks; ++b) {
+                    hin = advanceBlock(pv[b], mv[b], eqColumn[b], hin, HIGH_BIT);
+                }
+                score += advanceBlock(pv[blocks - 1], mv[blocks - 1], eqColumn[blocks - 1], hin, lastBit);
+                columns_++;
+
+                if (score <= k) {
+                    size_t start;
+                    int dist;
+                    if (locateStart(text, j, k, start, dist)) {
+                        found++;
+                        if (!detail::emitMatch(sink, start, 0, j + 1 - start, dist)) {
+                            break;
+                        }
+                    }
+                }
+            }
+
+            return found;
+        }
+
+        /**
+         * Get statistics about the last search
+         */
+        size_t getColumns() const { return columns_; }
+        size_t getBlockCount() const { return blocks_; }
+
+    private:
+        static constexpr size_t WORD_BITS = 64;
+        static constexpr uint64_t HIGH_BIT = uint64_t(1) << 63;
+
+        std::string pattern_;
+        size_t blocks_;                 // ceil(m / 64)
+        std::vector<uint64_t> peq_;     // Match masks, [byte * blocks_ + block]
+        std::vector<uint64_t> peqReverse_;  // Match masks of the reversed pattern
+        std::vector<uint64_t> pv_;      // Positive vertical deltas per block
+        std::vector<uint64_t> mv_;      // Negative vertical deltas per block
+        std::vector<uint64_t> startPv_; // Reverse pass deltas
+        std::vector<uint64_t> startMv_;
+        size_t columns_;
+
+        /**
+         * Build match masks and reset the vertical delta vectors
+         */
+        void preparePattern(const std::string& pattern);
+
+        /**
+         * One column step for one 64-row block
+         * @param hin Horizontal delta entering the block's top row (-1, 0, +1)
+         * @param outBit Row whose horizontal delta is returned
+         * @return Horizontal delta leaving the block at outBit
+         */
+        static inline int advanceBlock(uint64_t& pv, uint64_t& mv, uint64_t eq, int hin, uint64_t outBit) {
+            uint64_t hinNeg = hin < 0 ? 1 : 0;
+            uint64_t hinPos = hin > 0 ? 1 : 0;
+
+            uint64_t xv = eq | mv;
+            eq |= hinNeg;
+            uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            uint64_t ph = mv | ~(xh | pv);
+            uint64_t mh = pv & xh;
+
+            int hout = 0;
+            if (ph & outBit) hout = 1;
+            if (mh & outBit) hout = -1;
+
+            ph = (ph << 1) | hinPos;
+            mh = (mh << 1) | hinNeg;
+
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+
+            return hout;
+        }
+
+        /**
+         * Recover the start of the best alignment ending at textEnd: the
+         * reversed pattern against the text read backwards, with no free
+         * start, gives the distance for every candidate length in turn
+         * @return false if no non-empty alignment is within maxDistance
+         */
+        bool locateStart(const std::string& text, size_t textEnd, int maxDistance,
+            size_t& start, int& dist);
+    };
+
+} // namespace DNACore
\ No newline at end of file
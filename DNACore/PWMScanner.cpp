@@ -0,0 +1,574 @@
+#include "PWMScanner.h"
+#include "ThreadPool.h"
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <numeric>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DNACORE_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang compile each kernel for its own instruction set; MSVC accepts
+// the intrinsics without per-function targets
+#if defined(DNACORE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define DNACORE_TARGET_SSE2 __attribute__((target("sse2")))
+#define DNACORE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define DNACORE_TARGET_SSE2
+#define DNACORE_TARGET_AVX2
+#endif
+
+namespace DNACore {
+
+    namespace {
+
+        constexpr unsigned char NO_BASE = 4;
+
+        // Lanes of the widest kernel; masks are padded so its loads stay in bounds
+        constexpr size_t MAX_LANES = 16;
+
+        // Table score of a non-base: low enough that no window holding one
+        // survives, while sums of real columns (at least 64 * -256) stay
+        // clear of saturation
+        constexpr int16_t NO_BASE_SCORE = -16384;
+
+        // Columns added between lookahead checks: checking after every
+        // column costs more in mispredicted branches than it saves
+        constexpr int LOOKAHEAD_STEPS = 4;
+
+        // Texts shorter than this per chunk are scanned serially
+        constexpr size_t MIN_PARALLEL_CHUNK = 64 * 1024;
+
+        constexpr std::array<unsigned char, 256> makeBaseCodes() {
+            std::array<unsigned char, 256> table{};
+            for (auto& entry : table) {
+                entry = NO_BASE;
+            }
+            table['A'] = 0; table['a'] = 0;
+            table['C'] = 1; table['c'] = 1;
+            table['G'] = 2; table['g'] = 2;
+            table['T'] = 3; table['t'] = 3;
+            table['U'] = 3; table['u'] = 3;
+            return table;
+        }
+
+        constexpr std::array<unsigned char, 256> BASE_CODES = makeBaseCodes();
+
+        inline unsigned lowestSetBit(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+        }
+
+        /**
+         * Shared inputs of the scoring kernels for one variant and block
+         */
+        struct KernelInput {
+            const int* offsets;
+            const int16_t* scores;
+            const int* need;
+            int length;
+            bool lookahead;
+            size_t count;                   // Windows in the block
+        };
+
+        /**
+         * Branch-and-bound scoring of each window; survivors reach the threshold
+         */
+        void scoreScalar(const KernelInput& in, const unsigned char* codes,
+            std::vector<uint32_t>& survivors, size_t& columns) {
+
+            const int last = in.length;
+
+            // Per step, the scores of A, C, G, T and a non-base
+            int table[PositionWeightMatrix::MAX_LENGTH][NO_BASE + 1];
+            for (int k = 0; k < last; ++k) {
+                for (int b = 0; b < 4; ++b) {
+                    table[k][b] = in.scores[4 * k + b];
+                }
+                table[k][NO_BASE] = NO_BASE_SCORE;
+            }
+
+            for (size_t w = 0; w < in.count; ++w) {
+                const unsigned char* window = codes + w;
+                int score = 0;
+                int k = 0;
+                while (true) {
+                    int stop = std::min(k + LOOKAHEAD_STEPS, last);
+                    for (; k < stop; ++k) {
+                        score += table[k][window[in.offsets[k]]];
+                    }
+                    if (k == last || (in.lookahead && score < in.need[k])) {
+                        break;
+                    }
+                }
+                columns += static_cast<size_t>(k);
+                if (k == last && score >= in.need[last]) {
+                    survivors.push_back(static_cast<uint32_t>(w));
+                }
+            }
+        }
+
+#ifdef DNACORE_X86
+
+        DNACORE_TARGET_SSE2
+        void scoreSSE2(const KernelInput& in, const int16_t* masks, size_t stride,
+            std::vector<uint32_t>& survivors, size_t& columns) {
+
+            const int last = in.length;
+            __m128i scoreA[PositionWeightMatrix::MAX_LENGTH];
+            __m128i scoreC[PositionWeightMatrix::MAX_LENGTH];
+            __m128i scoreG[PositionWeightMatrix::MAX_LENGTH];
+            __m128i scoreT[PositionWeightMatrix::MAX_LENGTH];
+            __m128i below[PositionWeightMatrix::MAX_LENGTH + 1];     // need - 1, for a > compare
+
+            for (int k = 0; k < last; ++k) {
+                scoreA[k] = _mm_set1_epi16(in.scores[4 * k]);
+                scoreC[k] = _mm_set1_epi16(in.scores[4 * k + 1]);
+                scoreG[k] = _mm_set1_epi16(in.scores[4 * k + 2]);
+                scoreT[k] = _mm_set1_epi16(in.scores[4 * k + 3]);
+            }
+            for (int k = 0; k <= last; ++k) {
+                below[k] = _mm_set1_epi16(static_cast<int16_t>(in.need[k] - 1));
+            }
+
+            const int16_t* planeA = masks;
+            const int16_t* planeC = masks + stride;
+            const int16_t* planeG = masks + 2 * stride;
+            const int16_t* planeT = masks + 3 * stride;
+
+            for (size_t w = 0; w < in.count; w += 8) {
+                __m128i acc = _mm_setzero_si128();
+                int k = 0;
+                for (; k < last; ++k) {
+                    size_t at = w + in.offsets[k];
+                    __m128i a = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(planeA + at)), scoreA[k]);
+                    __m128i c = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(planeC + at)), scoreC[k]);
+                    __m128i g = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(planeG + at)), scoreG[k]);
+                    __m128i t = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(planeT + at)), scoreT[k]);
+                    acc = _mm_adds_epi16(acc, _mm_or_si128(_mm_or_si128(a, c), _mm_or_si128(g, t)));
+
+                    if (in.lookahead && (k + 1) % LOOKAHEAD_STEPS == 0 && _mm_movemask_epi8(_mm_cmpgt_epi16(acc, below[k + 1])) == 0) {
+                        break;
+                    }
+                }
+                columns += 8 * static_cast<size_t>(k < last ? k + 1 : last);
+                if (k < last) {
+                    continue;
+                }
+
+                // Two mask bits per 16-bit lane
+                unsigned pass = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi16(acc, below[last]))) & 0x5555u;
+                while (pass != 0) {
+                    size_t window = w + lowestSetBit(pass) / 2;
+                    if (window < in.count) {
+                        survivors.push_back(static_cast<uint32_t>(window));
+                    }
+                    pass &= pass - 1;
+                }
+            }
+        }
+
+        DNACORE_TARGET_AVX2
+        void scoreAVX2(const KernelInput& in, const int16_t* lookup,
+            std::vector<uint32_t>& survivors, size_t& columns) {
+
+            const int last = in.length;
+            __m256i table[PositionWeightMatrix::MAX_LENGTH];
+            __m256i below[PositionWeightMatrix::MAX_LENGTH + 1];
+
+            // Per step, the 16-bit scores of A, C, G, T and a non-base
+            for (int k = 0; k < last; ++k) {
+                table[k] = _mm256_setr_epi16(
+                    in.scores[4 * k], in.scores[4 * k + 1], in.scores[4 * k + 2], in.scores[4 * k + 3],
+                    NO_BASE_SCORE, 0, 0, 0,
+                    in.scores[4 * k], in.scores[4 * k + 1], in.scores[4 * k + 2], in.scores[4 * k + 3],
+                    NO_BASE_SCORE, 0, 0, 0);
+            }
+            for (int k = 0; k <= last; ++k) {
+                below[k] = _mm256_set1_epi16(static_cast<int16_t>(in.need[k] - 1));
+            }
+
+            for (size_t w = 0; w < in.count; w += 16) {
+                __m256i acc = _mm256_setzero_si256();
+                int k = 0;
+                for (; k < last; ++k) {
+                    __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lookup + w + in.offsets[k]));
+                    acc = _mm256_adds_epi16(acc, _mm256_shuffle_epi8(table[k], index));
+
+                    if (in.lookahead && (k + 1) % LOOKAHEAD_STEPS == 0 && _mm256_movemask_epi8(_mm256_cmpgt_epi16(acc, below[k + 1])) == 0) {
+                        break;
+                    }
+                }
+                columns += 16 * static_cast<size_t>(k < last ? k + 1 : last);
+                if (k < last) {
+                    continue;
+                }
+
+                unsigned pass = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi16(acc, below[last]))) & 0x55555555u;
+                while (pass != 0) {
+                    size_t window = w + lowestSetBit(pass) / 2;
+                    if (window < in.count) {
+                        survivors.push_back(static_cast<uint32_t>(window));
+                    }
+                    pass &= pass - 1;
+                }
+            }
+        }
+
+#endif // DNACORE_X86
+
+    } // namespace
+
+    PWMScanner::PWMScanner()
+        : maxLength_(0), windowsScored_(0), columnsScored_(0) {
+    }
+
+    PWMScanner::PWMScanner(const Config& config)
+        : config_(config), maxLength_(0), windowsScored_(0), columnsScored_(0) {
+    }
+
+    PWMScanner::~PWMScanner() {
+    }
+
+    void PWMScanner::setConfig(const Config& config) {
+        config_ = config;
+
+        std::vector<PositionWeightMatrix> matrices;
+        matrices.swap(matrices_);
+        clear();
+        addMatrices(matrices);
+    }
+
+    void PWMScanner::clear() {
+        matrices_.clear();
+        variants_.clear();
+        thresholds_.clear();
+        maxLength_ = 0;
+    }
+
+    int PWMScanner::addMatrix(const PositionWeightMatrix& matrix) {
+        if (matrix.empty() || matrix.length() > PositionWeightMatrix::MAX_LENGTH) {
+            return -1;
+        }
+
+        int matrixId = static_cast<int>(matrices_.size());
+        matrices_.push_back(matrix);
+        maxLength_ = std::max(maxLength_, matrix.length());
+
+        auto scores = matrix.logOdds(config_.background, config_.pseudocount);
+
+        Variant forward;
+        bool reachable = compileVariant(matrixId, '+', scores, forward);
+        thresholds_.push_back(reachable
+            ? static_cast<double>(forward.threshold) / PositionWeightMatrix::SCORE_SCALE
+            : std::numeric_limits<double>::infinity());
+        if (reachable) {
+            variants_.push_back(std::move(forward));
+        }
+
+        if (config_.bothStrands) {
+            // Reverse complement: columns reversed, A <-> T and C <-> G
+            std::vector<std::array<int, 4>> reverse(scores.rbegin(), scores.rend());
+            for (auto& column : reverse) {
+                std::swap(column[0], column[3]);
+                std::swap(column[1], column[2]);
+            }
+
+            // A palindromic matrix scores both strands the same
+            Variant minus;
+            if (reverse != scores && compileVariant(matrixId, '-', reverse, minus)) {
+                variants_.push_back(std::move(minus));
+            }
+        }
+
+        return matrixId;
+    }
+
+    void PWMScanner::addMatrices(const std::vector<PositionWeightMatrix>& matrices) {
+        for (const auto& matrix : matrices) {
+            addMatrix(matrix);
+        }
+    }
+
+    double PWMScanner::getThreshold(int matrixId) const {
+        return thresholds_[matrixId];
+    }
+
+    bool PWMScanner::compileVariant(int matrixId, char strand, const std::vector<std::array<int, 4>>& scores,
+        Variant& variant) const {
+
+        const auto& background = config_.background;
+        const int length = static_cast<int>(scores.size());
+
+        // Exact score distribution of a background window: dist[i] = P(sum = low + i)
+        std::vector<double> dist(1, 1.0);
+        std::vector<double> next;
+        int low = 0;
+        for (const auto& column : scores) {
+            int columnMin = *std::min_element(column.begin(), column.end());
+            int columnMax = *std::max_element(column.begin(), column.end());
+            next.assign(dist.size() + static_cast<size_t>(columnMax - columnMin), 0.0);
+            for (size_t i = 0; i < dist.size(); ++i) {
+                if (dist[i] == 0.0) {
+                    continue;
+                }
+                for (int b = 0; b < 4; ++b) {
+                    next[i + static_cast<size_t>(column[b] - columnMin)] += dist[i] * background[b];
+                }
+            }
+            dist.swap(next);
+            low += columnMin;
+        }
+        const int maxScore = low + static_cast<int>(dist.size()) - 1;
+
+        // Threshold: the lowest score whose upper tail stays within the p-value
+        int threshold;
+        if (config_.pValue > 0.0) {
+            threshold = maxScore + 1;
+            double tail = 0.0;
+            for (size_t i = dist.size(); i-- > 0;) {
+                tail += dist[i];
+                if (tail > config_.pValue * (1.0 + 1e-9)) {
+                    break;
+                }
+                threshold = low + static_cast<int>(i);
+            }
+        }
+        else {
+            threshold = static_cast<int>(std::ceil(config_.minScore * PositionWeightMatrix::SCORE_SCALE - 1e-9));
+            threshold = std::max(threshold, low);
+        }
+
+        if (threshold > maxScore) {
+            return false;
+        }
+
+        variant.matrixId = matrixId;
+        variant.strand = strand;
+        variant.length = length;
+        variant.threshold = threshold;
+        variant.maxScore = maxScore;
+
+        variant.tail.assign(static_cast<size_t>(maxScore - threshold + 1), 0.0f);
+        double tail = 0.0;
+        for (int s = maxScore; s >= threshold; --s) {
+            tail += dist[static_cast<size_t>(s - low)];
+            variant.tail[static_cast<size_t>(s - threshold)] = static_cast<float>(std::min(tail, 1.0));
+        }
+
+        // Most informative columns first: the largest gap between the best
+        // score and the background expectation prunes soonest
+        std::vector<double> gain(scores.size());
+        for (size_t j = 0; j < scores.size(); ++j) {
+            double expected = 0.0;
+            for (int b = 0; b < 4; ++b) {
+                expected += background[b] * scores[j][b];
+            }
+            gain[j] = *std::max_element(scores[j].begin(), scores[j].end()) - expected;
+        }
+        variant.offsets.resize(scores.size());
+        std::iota(variant.offsets.begin(), variant.offsets.end(), 0);
+        std::stable_sort(variant.offsets.begin(), variant.offsets.end(),
+            [&gain](int a, int b) { return gain[a] > gain[b]; });
+
+        variant.scores.resize(4 * scores.size());
+        for (int k = 0; k < length; ++k) {
+            for (int b = 0; b < 4; ++b) {
+                variant.scores[4 * k + b] = static_cast<int16_t>(scores[variant.offsets[k]][b]);
+            }
+        }
+
+        // need[k]: the threshold minus the best the remaining steps can add
+        variant.need.assign(static_cast<size_t>(length) + 1, threshold);
+        int reachable = 0;
+        for (int k = length; k-- > 0;) {
+            reachable += *std::max_element(scores[variant.offsets[k]].begin(), scores[variant.offsets[k]].end());
+            variant.need[k] = threshold - reachable;
+        }
+
+        return true;
+    }
+
+    void PWMScanner::scanWindows(const char* text, size_t length, size_t begin, size_t end,
+        Scratch& scratch, std::vector<PWMHit>& hits) const {
+
+        scratch.windows = 0;
+        scratch.columns = 0;
+        if (begin >= end || variants_.empty()) {
+            return;
+        }
+
+        const size_t count = end - begin;
+        const size_t stride = count + maxLength_ + MAX_LANES;
+
+        // Decode the block once for every matrix
+        scratch.codes.resize(stride);
+        for (size_t p = 0; p < stride; ++p) {
+            size_t position = begin + p;
+            scratch.codes[p] = position < length
+                ? BASE_CODES[static_cast<unsigned char>(text[position])]
+                : NO_BASE;
+        }
+
+        CompositionKernel::Kernel kernel = config_.kernel;
+        if (kernel == CompositionKernel::Kernel::AUTO) {
+            kernel = CompositionKernel::activeKernel();
+        }
+        if (!CompositionKernel::isSupported(kernel)) {
+            kernel = CompositionKernel::Kernel::SCALAR;
+        }
+
+        if (kernel == CompositionKernel::Kernel::AVX2) {
+            // Byte pairs selecting a 16-bit table entry: 2 * code, 2 * code + 1
+            scratch.masks.resize(stride);
+            for (size_t p = 0; p < stride; ++p) {
+                unsigned index = 2u * scratch.codes[p];
+                scratch.masks[p] = static_cast<int16_t>(index | ((index + 1) << 8));
+            }
+        }
+        else if (kernel == CompositionKernel::Kernel::SSE2) {
+            scratch.masks.assign(4 * stride, 0);
+            for (size_t p = 0; p < stride; ++p) {
+                unsigned code = scratch.codes[p];
+                if (code != NO_BASE) {
+                    scratch.masks[code * stride + p] = -1;
+                }
+            }
+        }
+
+        const size_t firstHit = hits.size();
+
+        for (const Variant& variant : variants_) {
+            const size_t m = static_cast<size_t>(variant.length);
+            if (begin + m > length) {
+                continue;
+            }
+
+            // Windows of this variant that fit in the text
+            size_t limit = std::min(count, length - m - begin + 1);
+
+            KernelInput in;
+            in.offsets = variant.offsets.data();
+            in.scores = variant.scores.data();
+            in.need = variant.need.data();
+            in.length = variant.length;
+            in.lookahead = config_.lookahead;
+            in.count = limit;
+
+            scratch.survivors.clear();
+            switch (kernel) {
+#ifdef DNACORE_X86
+            case CompositionKernel::Kernel::AVX2:
+                scoreAVX2(in, scratch.masks.data(), scratch.survivors, scratch.columns);
+                break;
+            case CompositionKernel::Kernel::SSE2:
+                scoreSSE2(in, scratch.masks.data(), stride, scratch.survivors, scratch.columns);
+                break;
+#endif
+            default:
+                scoreScalar(in, scratch.codes.data(), scratch.survivors, scratch.columns);
+                break;
+            }
+            scratch.windows += limit;
+
+            // Rescore survivors exactly: vector lanes saturate and ignore
+            // bytes that are not bases
+            for (uint32_t w : scratch.survivors) {
+                const unsigned char* window = scratch.codes.data() + w;
+                int score = 0;
+                bool valid = true;
+                for (size_t k = 0; k < m; ++k) {
+                    unsigned code = window[variant.offsets[k]];
+                    if (code == NO_BASE) {
+                        valid = false;
+                        break;
+                    }
+                    score += variant.scores[4 * k + code];
+                }
+                if (!valid || score < variant.threshold) {
+                    continue;
+                }
+
+                hits.emplace_back(begin + w, variant.matrixId, m, variant.strand,
+                    static_cast<double>(score) / PositionWeightMatrix::SCORE_SCALE,
+                    variant.tail[static_cast<size_t>(score - variant.threshold)]);
+            }
+        }
+
+        std::sort(hits.begin() + firstHit, hits.end(), [](const PWMHit& a, const PWMHit& b) {
+            if (a.position != b.position) return a.position < b.position;
+            if (a.matrixId != b.matrixId) return a.matrixId < b.matrixId;
+            return a.strand < b.strand;
+        });
+    }
+
+    std::vector<PWMHit> PWMScanner::scan(const std::string& text) {
+        std::vector<PWMHit> hits;
+        scanEach(text, [&hits](const PWMHit& hit) { hits.push_back(hit); });
+        return hits;
+    }
+
+    std::vector<PWMHit> PWMScanner::scanParallel(const std::string& text, size_t numThreads) {
+        if (numThreads == 0) {
+            numThreads = ThreadPool::defaultThreadCount();
+        }
+
+        size_t chunkCount = std::min(numThreads, text.length() / MIN_PARALLEL_CHUNK);
+        if (chunkCount <= 1) {
+            return scan(text);
+        }
+
+        // Chunks own the windows starting in them, so no hit is reported twice
+        size_t chunkSize = (text.length() + chunkCount - 1) / chunkCount;
+
+        struct ChunkResult {
+            std::vector<PWMHit> hits;
+            size_t windows = 0;
+            size_t columns = 0;
+        };
+
+        std::vector<std::future<ChunkResult>> futures;
+        futures.reserve(chunkCount);
+
+        for (size_t c = 0; c < chunkCount; ++c) {
+            size_t start = c * chunkSize;
+            size_t stop = std::min(text.length(), start + chunkSize);
+
+            futures.push_back(ThreadPool::shared().submit([this, &text, start, stop]() {
+                ChunkResult result;
+                Scratch scratch;
+                for (size_t begin = start; begin < stop; begin += BLOCK_WINDOWS) {
+                    scanWindows(text.data(), text.length(), begin, std::min(stop, begin + BLOCK_WINDOWS),
+                        scratch, result.hits);
+                    result.windows += scratch.windows;
+                    result.columns += scratch.columns;
+                }
+                return result;
+            }));
+        }
+
+        std::vector<PWMHit> hits;
+        windowsScored_ = 0;
+        columnsScored_ = 0;
+        for (auto& future : futures) {
+            ChunkResult result = future.get();
+            std::move(result.hits.begin(), result.hits.end(), std::back_inserter(hits));
+            windowsScored_ += result.windows;
+            columnsScored_ += result.columns;
+        }
+
+        return hits;
+    }
+
+} // namespace DNACore
\ No newline at end of file
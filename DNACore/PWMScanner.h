@@ -0,0 +1,236 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "CompositionKernel.h"
+#include "PositionWeightMatrix.h"
+
+namespace DNACore {
+
+    /**
+     * One window scoring at or above its matrix threshold
+     */
+    struct PWMHit {
+        size_t position;              // 0-based start on the forward strand
+        int matrixId;                 // Index of the matrix in the scanner
+        size_t length;
+        char strand;                  // '-': scored against the reverse complement
+        double score;                 // Log-odds in bits
+        double pValue;                // P(score >= this) for a background window
+
+        PWMHit()
+            : position(0), matrixId(0), length(0), strand('+'), score(0.0), pValue(1.0) {
+        }
+
+        PWMHit(size_t pos, int id, size_t len, char str, double s, double p)
+            : position(pos), matrixId(id), length(len), strand(str), score(s), pValue(p) {
+        }
+    };
+
+    /**
+     * Position weight matrix scanner for many matrices at once
+     * Every matrix is compiled to integer log-odds (see PositionWeightMatrix)
+     * and, with bothStrands, to a second matrix for its reverse complement,
+     * so the minus strand is scored in the same forward pass. Palindromic
+     * matrices are compiled once. A p-value cutoff is turned into a score
+     * threshold per matrix from the exact score distribution under the
+     * background (dynamic programming over integer scores).
+     *
+     * Text is scanned in blocks of BLOCK_WINDOWS windows. Each block is
+     * decoded once for all matrices (per-base lane masks for SSE2, byte
+     * shuffle indices for AVX2); the kernels then score 8 or 16 adjacent
+     * windows per column in saturating 16-bit lanes. Columns are visited
+     * most informative first, and every few columns the lanes are checked
+     * against the best score still reachable (lookahead / branch and
+     * bound): once no lane can reach the threshold the group is abandoned,
+     * so most windows cost a few columns rather than the full matrix
+     * length. Surviving windows are rescored exactly; windows holding
+     * anything but A/C/G/T/U never match.
+     */
+    class PWMScanner {
+    public:
+        // Windows scored per block, sharing one decode of the text
+        static constexpr size_t BLOCK_WINDOWS = 1024;
+
+        static constexpr double DEFAULT_P_VALUE = 1e-4;
+
+        struct Config {
+            PositionWeightMatrix::Column background;   // A, C, G, T probabilities
+            double pseudocount;
+            double pValue;          // Report windows with P(score >= s) <= pValue...
+            double minScore;        // ...or, when pValue is 0, scoring >= minScore bits
+            bool bothStrands;
+            bool lookahead;         // Abandon windows that cannot reach the threshold
+            CompositionKernel::Kernel kernel;
+
+            Config()
+                : background{ { 0.25, 0.25, 0.25, 0.25 } },
+                pseudocount(PositionWeightMatrix::DEFAULT_PSEUDOCOUNT),
+                pValue(DEFAULT_P_VALUE), minScore(0.0),
+                bothStrands(true), lookahead(true),
+                kernel(CompositionKernel::Kernel::AUTO) {
+            }
+        };
+
+        PWMScanner();
+        explicit PWMScanner(const Config& config);
+        ~PWMScanner();
+
+        /**
+         * Replace the configuration, recompiling every matrix
+         */
+        void setConfig(const Config& config);
+        const Config& getConfig() const { return config_; }
+
+        /**
+         * Compile a matrix
+         * @return Its id, or -1 if it is empty or longer than
+         *         PositionWeightMatrix::MAX_LENGTH
+         */
+        int addMatrix(const PositionWeightMatrix& matrix);
+
+        void addMatrices(const std::vector<PositionWeightMatrix>& matrices);
+
+        void clear();
+
+        size_t getMatrixCount() const { return matrices_.size(); }
+        const PositionWeightMatrix& getMatrix(int matrixId) const { return matrices_[matrixId]; }
+
+        /**
+         * Forward-strand score threshold of a matrix, in bits
+         */
+        double getThreshold(int matrixId) const;
+
+        /**
+         * Compiled matrices, counting reverse complements
+         */
+        size_t getVariantCount() const { return variants_.size(); }
+
+        /**
+         * Scan text against every matrix: calls sink(const PWMHit&) for each
+         * hit in order of position, then matrix id, then strand. The sink
+         * may return false to stop the scan.
+         * @return Number of hits delivered
+         */
+        template <typename Sink>
+        size_t scanEach(const char* text, size_t length, Sink&& sink) {
+            windowsScored_ = 0;
+            columnsScored_ = 0;
+
+            Scratch scratch;
+            std::vector<PWMHit> hits;
+            size_t found = 0;
+
+            for (size_t begin = 0; begin < length; begin += BLOCK_WINDOWS) {
+                hits.clear();
+                scanWindows(text, length, begin, std::min(length, begin + BLOCK_WINDOWS), scratch, hits);
+                windowsScored_ += scratch.windows;
+                columnsScored_ += scratch.columns;
+
+                for (const PWMHit& hit : hits) {
+                    found++;
+                    if (!emitHit(sink, hit)) {
+                        return found;
+                    }
+                }
+            }
+            return found;
+        }
+
+        template <typename Sink>
+        size_t scanEach(const std::string& text, Sink&& sink) {
+            return scanEach(text.data(), text.length(), sink);
+        }
+
+        /**
+         * Collect every hit
+         */
+        std::vector<PWMHit> scan(const std::string& text);
+
+        /**
+         * scan() split into chunks on ThreadPool::shared(); same hits in the
+         * same order. Must not be called from a pool task.
+         * @param numThreads Number of chunks (0 = hardware concurrency)
+         */
+        std::vector<PWMHit> scanParallel(const std::string& text, size_t numThreads = 0);
+
+        // ===== STATISTICS =====
+
+        /**
+         * Windows times compiled matrices examined by the last scan
+         */
+        size_t getWindowsScored() const { return windowsScored_; }
+
+        /**
+         * Matrix columns added up by the last scan; divided by
+         * getWindowsScored() this shows how much the lookahead saved
+         */
+        size_t getColumnsScored() const { return columnsScored_; }
+
+    private:
+        /**
+         * A matrix (or its reverse complement) ready to scan
+         */
+        struct Variant {
+            int matrixId;
+            char strand;
+            int length;
+            int threshold;                  // Integer score to reach
+            int maxScore;
+            std::vector<int> offsets;       // Column scored at each step, most informative first
+            std::vector<int16_t> scores;    // Per step: A, C, G, T
+            std::vector<int> need;          // need[k]: score required after k steps
+            std::vector<float> tail;        // P(score >= threshold + i)
+        };
+
+        /**
+         * Per-scan buffers: the block decoded as codes and lane masks
+         */
+        struct Scratch {
+            std::vector<unsigned char> codes;
+            std::vector<int16_t> masks;     // SSE2: four planes (A, C, G, T), -1 where the base is;
+                                            // AVX2: one plane of shuffle index pairs
+            std::vector<uint32_t> survivors;
+            size_t windows = 0;
+            size_t columns = 0;
+        };
+
+        Config config_;
+        std::vector<PositionWeightMatrix> matrices_;
+        std::vector<Variant> variants_;
+        std::vector<double> thresholds_;    // Per matrix, in bits (infinity if unreachable)
+        size_t maxLength_;
+        size_t windowsScored_;
+        size_t columnsScored_;
+
+        template <typename Sink>
+        static bool emitHit(Sink& sink, const PWMHit& hit) {
+            if constexpr (std::is_same<decltype(sink(hit)), bool>::value) {
+                return sink(hit);
+            }
+            else {
+                sink(hit);
+                return true;
+            }
+        }
+
+        /**
+         * Score windows starting in [begin, end) against every variant,
+         * appending hits in scanEach() order (scratch counters are reset)
+         */
+        void scanWindows(const char* text, size_t length, size_t begin, size_t end,
+            Scratch& scratch, std::vector<PWMHit>& hits) const;
+
+        /**
+         * Build the variant of a matrix for one strand
+         * @return false if no window can reach the threshold
+         */
+        bool compileVariant(int matrixId, char strand, const std::vector<std::array<int, 4>>& scores,
+            Variant& variant) const;
+    };
+
+} // namespace DNACore
\ No newline at end of file
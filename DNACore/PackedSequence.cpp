@@ -0,0 +1,381 @@
+#include "PackedSequence.h"
+#include <array>
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace DNACore {
+
+    namespace {
+
+        constexpr unsigned EXCEPTION_CODE = 4;
+
+        // Byte -> 2-bit code; the minority of T/U becomes an exception
+        constexpr std::array<unsigned char, 256> makeCodeTable(bool rna) {
+            std::array<unsigned char, 256> table{};
+            for (auto& entry : table) {
+                entry = EXCEPTION_CODE;
+            }
+            table['A'] = 0;
+            table['C'] = 1;
+            table['G'] = 2;
+            table[rna ? 'U' : 'T'] = 3;
+            return table;
+        }
+
+        constexpr std::array<unsigned char, 256> DNA_CODES = makeCodeTable(false);
+        constexpr std::array<unsigned char, 256> RNA_CODES = makeCodeTable(true);
+
+        // One packed byte (4 bases) -> 4 letters
+        struct DecodeTable {
+            char bases[256][4];
+        };
+
+        constexpr DecodeTable makeDecodeTable(bool rna) {
+            const char letters[4] = { 'A', 'C', 'G', rna ? 'U' : 'T' };
+            DecodeTable table{};
+            for (int byte = 0; byte < 256; ++byte) {
+                for (int k = 0; k < 4; ++k) {
+                    table.bases[byte][k] = letters[(byte >> (2 * k)) & 3];
+                }
+            }
+            return table;
+        }
+
+        constexpr DecodeTable DNA_DECODE = makeDecodeTable(false);
+        constexpr DecodeTable RNA_DECODE = makeDecodeTable(true);
+
+        // IUPAC complement; bytes without one map to themselves
+        constexpr std::array<char, 256> makeComplementTable() {
+            std::array<char, 256> table{};
+            for (int byte = 0; byte < 256; ++byte) {
+                table[byte] = static_cast<char>(byte);
+            }
+            const char pairs[][2] = {
+                { 'A', 'T' }, { 'C', 'G' }, { 'R', 'Y' }, { 'K', 'M' }, { 'B', 'V' }, { 'D', 'H' },
+                { 'a', 't' }, { 'c', 'g' }, { 'r', 'y' }, { 'k', 'm' }, { 'b', 'v' }, { 'd', 'h' }
+            };
+            for (const auto& pair : pairs) {
+                table[static_cast<unsigned char>(pair[0])] = pair[1];
+                table[static_cast<unsigned char>(pair[1])] = pair[0];
+            }
+            table['U'] = 'A';
+            table['u'] = 'a';
+            return table;
+        }
+
+        constexpr std::array<char, 256> COMPLEMENT = makeComplementTable();
+
+        constexpr uint64_t LOW_BITS = 0x5555555555555555ULL;
+
+        inline size_t popcount(uint64_t value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+            return static_cast<size_t>(__popcnt64(value));
+#else
+            return static_cast<size_t>(__builtin_popcountll(value));
+#endif
+        }
+
+        inline uint64_t lowMask(size_t bases) {
+            return bases >= PackedSequence::BASES_PER_WORD ? ~0ULL : (1ULL << (2 * bases)) - 1;
+        }
+
+        /**
+         * Reverse the order of the 32 2-bit codes in a word
+         */
+        inline uint64_t reverseCodes(uint64_t word) {
+            word = ((word >> 2) & 0x3333333333333333ULL) | ((word & 0x3333333333333333ULL) << 2);
+            word = ((word >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((word & 0x0F0F0F0F0F0F0F0FULL) << 4);
+            word = ((word >> 8) & 0x00FF00FF00FF00FFULL) | ((word & 0x00FF00FF00FF00FFULL) << 8);
+            word = ((word >> 16) & 0x0000FFFF0000FFFFULL) | ((word & 0x0000FFFF0000FFFFULL) << 16);
+            return (word >> 32) | (word << 32);
+        }
+
+    } // namespace
+
+    PackedSequence::PackedSequence()
+        : length_(0), rna_(false) {
+    }
+
+    PackedSequence::PackedSequence(const char* data, size_t length)
+        : length_(0), rna_(false) {
+        assign(data, length);
+    }
+
+    PackedSequence::PackedSequence(const std::string& sequence)
+        : length_(0), rna_(false) {
+        assign(sequence);
+    }
+
+    PackedSequence::~PackedSequence() {
+    }
+
+    void PackedSequence::clear() {
+        words_.clear();
+        exceptions_.clear();
+        length_ = 0;
+        rna_ = false;
+    }
+
+    size_t PackedSequence::memoryUsage() const {
+        return words_.capacity() * sizeof(uint64_t) + exceptions_.capacity() * sizeof(PackedException);
+    }
+
+    void PackedSequence::assign(const char* data, size_t length) {
+        clear();
+
+        // Pack whichever of T/U is more common; the other becomes exceptions
+        BaseComposition composition = CompositionKernel::count(data, length);
+        rna_ = composition.uracil > composition.thymine;
+        const unsigned char* codes = rna_ ? RNA_CODES.data() : DNA_CODES.data();
+
+        length_ = length;
+        words_.assign((length + BASES_PER_WORD - 1) / BASES_PER_WORD, 0);
+
+        for (size_t w = 0; w < words_.size(); ++w) {
+            size_t base = w * BASES_PER_WORD;
+            size_t count = std::min(BASES_PER_WORD, length - base);
+            uint64_t word = 0;
+
+            for (size_t k = 0; k < count; ++k) {
+                unsigned code = codes[static_cast<unsigned char>(data[base + k])];
+                if (code == EXCEPTION_CODE) {
+                    addException(base + k, 1, data[base + k]);
+                    code = 0;
+                }
+                word |= static_cast<uint64_t>(code) << (2 * k);
+            }
+
+            words_[w] = word;
+        }
+    }
+
+    char PackedSequence::baseAt(size_t position) const {
+        size_t run = firstRunAfter(position);
+        if (run < exceptions_.size() && exceptions_[run].start <= position) {
+            return exceptions_[run].symbol;
+        }
+        return (rna_ ? RNA_DECODE : DNA_DECODE).bases[codeAt(position)][0];
+    }
+
+    size_t PackedSequence::extract(size_t position, size_t length, char* out) const {
+        if (position >= length_) {
+            return 0;
+        }
+        const size_t count = std::min(length, length_ - position);
+        const size_t end = position + count;
+        const DecodeTable& decode = rna_ ? RNA_DECODE : DNA_DECODE;
+
+        char* dst = out;
+        size_t i = position;
+
+        // Single bases up to a 4-base boundary, then one table entry per packed byte
+        for (; i < end && (i & 3) != 0; ++i) {
+            *dst++ = decode.bases[codeAt(i)][0];
+        }
+        for (; i + 4 <= end; i += 4) {
+            unsigned byte = static_cast<unsigned>(words_[i / BASES_PER_WORD] >> (2 * (i % BASES_PER_WORD))) & 0xFFu;
+            std::memcpy(dst, decode.bases[byte], 4);
+            dst += 4;
+        }
+        for (; i < end; ++i) {
+            *dst++ = decode.bases[codeAt(i)][0];
+        }
+
+        // Overlay the exception runs inside the range
+        for (size_t r = firstRunAfter(position); r < exceptions_.size() && exceptions_[r].start < end; ++r) {
+            const PackedException& run = exceptions_[r];
+            size_t from = std::max(run.start, position);
+            size_t to = std::min(run.end(), end);
+            std::memset(out + (from - position), run.symbol, to - from);
+        }
+
+        return count;
+    }
+
+    std::string PackedSequence::extract(size_t position, size_t length) const {
+        std::string result;
+        if (position >= length_) {
+            return result;
+        }
+        result.resize(std::min(length, length_ - position));
+        extract(position, result.length(), &result[0]);
+        return result;
+    }
+
+    PackedSequence PackedSequence::subsequence(size_t start, size_t length) const {
+        PackedSequence result;
+        result.rna_ = rna_;
+        if (start >= length_) {
+            return result;
+        }
+
+        const size_t count = std::min(length, length_ - start);
+        const size_t end = start + count;
+        if (count == 0) {
+            return result;
+        }
+        result.length_ = count;
+        result.words_.resize((count + BASES_PER_WORD - 1) / BASES_PER_WORD);
+
+        for (size_t w = 0; w < result.words_.size(); ++w) {
+            result.words_[w] = windowAt(start + w * BASES_PER_WORD);
+        }
+        result.words_.back() &= lowMask(count - (result.words_.size() - 1) * BASES_PER_WORD);
+
+        for (size_t r = firstRunAfter(start); r < exceptions_.size() && exceptions_[r].start < end; ++r) {
+            const PackedException& run = exceptions_[r];
+            size_t from = std::max(run.start, start);
+            size_t to = std::min(run.end(), end);
+            result.exceptions_.emplace_back(from - start, to - from, run.symbol);
+        }
+
+        return result;
+    }
+
+    PackedSequence PackedSequence::reverseComplement() const {
+        PackedSequence result;
+        result.rna_ = rna_;
+        result.length_ = length_;
+        result.words_.resize(words_.size());
+
+        // Output word w holds the complemented input bases ending at n - 32w, reversed
+        for (size_t w = 0; w < words_.size(); ++w) {
+            size_t count = std::min(BASES_PER_WORD, length_ - w * BASES_PER_WORD);
+            size_t sourceStart = length_ - w * BASES_PER_WORD - count;
+
+            uint64_t word = ~windowAt(sourceStart) & lowMask(count);
+            result.words_[w] = reverseCodes(word) >> (2 * (BASES_PER_WORD - count));
+        }
+
+        // Exception runs come out in reverse order; complements that can be
+        // packed (e.g. the minority T/U becoming A) are written as codes
+        const unsigned char* codes = rna_ ? RNA_CODES.data() : DNA_CODES.data();
+        for (size_t r = exceptions_.size(); r-- > 0;) {
+            const PackedException& run = exceptions_[r];
+            char symbol = COMPLEMENT[static_cast<unsigned char>(run.symbol)];
+            size_t start = length_ - run.end();
+            unsigned code = codes[static_cast<unsigned char>(symbol)];
+
+            if (code == EXCEPTION_CODE) {
+                result.addException(start, run.length, symbol);
+                code = 0;
+            }
+            result.fillCodes(start, run.length, code);
+        }
+
+        return result;
+    }
+
+    BaseComposition PackedSequence::composition() const {
+        // Per word: code 1 = low bit only, 2 = high bit only, 3 = both
+        size_t counts[4] = {};
+        for (uint64_t word : words_) {
+            uint64_t low = word & LOW_BITS;
+            uint64_t high = (word >> 1) & LOW_BITS;
+            counts[1] += popcount(low & ~high);
+            counts[2] += popcount(high & ~low);
+            counts[3] += popcount(low & high);
+        }
+        counts[0] = length_ - counts[1] - counts[2] - counts[3];
+
+        BaseComposition result;
+        for (const PackedException& run : exceptions_) {
+            // Exception positions hold code 0
+            counts[0] -= run.length;
+
+            switch (run.symbol) {
+            case 'T': result.thymine += run.length; break;
+            case 'U': result.uracil += run.length; break;
+            case 'N': result.unknown += run.length; break;
+            default: result.other += run.length; break;
+            }
+        }
+
+        result.adenine = counts[0];
+        result.cytosine = counts[1];
+        result.guanine = counts[2];
+        (rna_ ? result.uracil : result.thymine) += counts[3];
+        return result;
+    }
+
+    std::vector<MatchResult> PackedSequence::find(const std::string& pattern) const {
+        std::vector<MatchResult> results;
+
+        findEach(pattern, [&](size_t position, int, size_t, int editDistance) {
+            results.emplace_back(
+                position,
+                pattern,
+                editDistance,  // 0 (exact match)
+                "Exact Match",
+                "Packed"
+            );
+        });
+
+        return results;
+    }
+
+    uint64_t PackedSequence::windowAt(size_t position) const {
+        size_t word = position / BASES_PER_WORD;
+        size_t shift = 2 * (position % BASES_PER_WORD);
+        if (word >= words_.size()) {
+            return 0;
+        }
+
+        uint64_t result = words_[word] >> shift;
+        if (shift != 0 && word + 1 < words_.size()) {
+            result |= words_[word + 1] << (64 - shift);
+        }
+        return result;
+    }
+
+    size_t PackedSequence::firstRunAfter(size_t position) const {
+        auto it = std::lower_bound(exceptions_.begin(), exceptions_.end(), position,
+            [](const PackedException& run, size_t pos) { return run.end() <= pos; });
+        return static_cast<size_t>(it - exceptions_.begin());
+    }
+
+    void PackedSequence::addException(size_t start, size_t length, char symbol) {
+        if (!exceptions_.empty() && exceptions_.back().end() == start && exceptions_.back().symbol == symbol) {
+            exceptions_.back().length += length;
+            return;
+        }
+        exceptions_.emplace_back(start, length, symbol);
+    }
+
+    void PackedSequence::fillCodes(size_t start, size_t length, unsigned code) {
+        const uint64_t pattern = LOW_BITS * code;     // code repeated in every slot
+        size_t i = start;
+        const size_t end = start + length;
+
+        while (i < end) {
+            size_t word = i / BASES_PER_WORD;
+            size_t offset = i % BASES_PER_WORD;
+            size_t take = std::min(BASES_PER_WORD - offset, end - i);
+            uint64_t mask = lowMask(take) << (2 * offset);
+
+            words_[word] = (words_[word] & ~mask) | (pattern & mask);
+            i += take;
+        }
+    }
+
+    bool PackedSequence::packPattern(const std::string& pattern, uint64_t& code) const {
+        if (pattern.empty() || pattern.length() > MAX_PACKED_PATTERN) {
+            return false;
+        }
+
+        const unsigned char* codes = rna_ ? RNA_CODES.data() : DNA_CODES.data();
+        code = 0;
+        for (size_t k = 0; k < pattern.length(); ++k) {
+            unsigned value = codes[static_cast<unsigned char>(pattern[k])];
+            if (value == EXCEPTION_CODE) {
+                return false;
+            }
+            code |= static_cast<uint64_t>(value) << (2 * k);
+        }
+        return true;
+    }
+
+} // namespace DNACore
\ No newline at end of file
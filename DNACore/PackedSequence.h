@@ -0,0 +1,254 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "AnalysisTypes.h"
+#include "CompositionKernel.h"
+
+namespace DNACore {
+
+    /**
+     * Run of identical bases that cannot be stored in 2 bits
+     * (N and other IUPAC codes, lowercase letters, or the minority of T/U)
+     */
+    struct PackedException {
+        size_t start;
+        size_t length;
+        char symbol;
+
+        PackedException(size_t s, size_t len, char sym) : start(s), length(len), symbol(sym) {}
+
+        size_t end() const { return start + length; }
+    };
+
+    /**
+     * 2-bit packed nucleotide sequence
+     * A, C, G and T/U are stored as codes 0..3, 32 bases per 64-bit word
+     * with base i at bits 2 * (i % 32) of word i / 32. Whether code 3 reads
+     * back as T or U is a per-sequence flag, chosen from whichever is more
+     * common. Every other byte is kept in a sorted list of exception runs
+     * (its packed code is 0), so unpacking always reproduces the input
+     * exactly. Typical genomes take a quarter of the std::string size.
+     */
+    class PackedSequence {
+    public:
+        static constexpr size_t BASES_PER_WORD = 32;
+
+        // Longest pattern findEach() compares as a single packed word
+        static constexpr size_t MAX_PACKED_PATTERN = 32;
+
+        // Bases decoded at a time by forEachBlock()
+        static constexpr size_t BLOCK_SIZE = 4096;
+
+        PackedSequence();
+        PackedSequence(const char* data, size_t length);
+        explicit PackedSequence(const std::string& sequence);
+        ~PackedSequence();
+
+        /**
+         * Pack a sequence, replacing the current contents
+         */
+        void assign(const char* data, size_t length);
+
+        void assign(const std::string& sequence) { assign(sequence.data(), sequence.length()); }
+
+        void clear();
+
+        size_t size() const { return length_; }
+        bool empty() const { return length_ == 0; }
+
+        /**
+         * Code 3 reads back as U rather than T
+         */
+        bool isRNA() const { return rna_; }
+
+        const std::vector<PackedException>& exceptions() const { return exceptions_; }
+
+        /**
+         * Bytes held by the packed words and exception runs
+         */
+        size_t memoryUsage() const;
+
+        // ===== ACCESS =====
+
+        /**
+         * Get one base (no bounds check)
+         */
+        char baseAt(size_t position) const;
+
+        /**
+         * Raw 2-bit code of one base (0 for exception positions)
+         */
+        unsigned codeAt(size_t position) const {
+            return static_cast<unsigned>(words_[position / BASES_PER_WORD] >> (2 * (position % BASES_PER_WORD))) & 3u;
+        }
+
+        /**
+         * Decode [position, position + length) into out (clipped)
+         * @return Number of bases written
+         */
+        size_t extract(size_t position, size_t length, char* out) const;
+
+        std::string extract(size_t position, size_t length) const;
+
+        /**
+         * Decode the whole sequence
+         */
+        std::string unpack() const { return extract(0, length_); }
+
+        /**
+         * Visit [position, position + length) as decoded blocks of up to
+         * BLOCK_SIZE bases, calling visit(std::string_view) for each in
+         * order. The range is clipped to the sequence.
+         * @return false if the visitor returned false
+         */
+        template <typename Visitor>
+        bool forEachBlock(size_t position, size_t length, Visitor&& visit) const {
+            if (position >= length_) {
+                return true;
+            }
+            size_t end = position + std::min(length, length_ - position);
+            char block[BLOCK_SIZE];
+
+            while (position < end) {
+                size_t take = extract(position, std::min(end - position, BLOCK_SIZE), block);
+                if (!visit(std::string_view(block, take))) {
+                    return false;
+                }
+                position += take;
+            }
+            return true;
+        }
+
+        template <typename Visitor>
+        bool forEachBlock(Visitor&& visit) const {
+            return forEachBlock(0, length_, std::forward<Visitor>(visit));
+        }
+
+        // ===== TRANSFORMS =====
+
+        /**
+         * Copy of [start, start + length) (clipped), shifted word-wise
+         */
+        PackedSequence subsequence(size_t start, size_t length) const;
+
+        /**
+         * Reverse complement, computed on whole words; IUPAC exception
+         * codes are complemented as well (R <-> Y, K <-> M, B <-> V, D <-> H)
+         */
+        PackedSequence reverseComplement() const;
+
+        // ===== PACKED-DOMAIN ALGORITHMS =====
+
+        /**
+         * Base counts from popcounts over the packed words
+         */
+        BaseComposition composition() const;
+
+        /**
+         * Check whether findEach() can search a pattern in the packed
+         * domain: 1..MAX_PACKED_PATTERN bases of A, C, G and the T/U letter
+         * this sequence packs
+         */
+        bool canSearchPacked(const std::string& pattern) const {
+            uint64_t code;
+            return packPattern(pattern, code);
+        }
+
+        /**
+         * Exact search by comparing a rolling packed window against the
+         * packed pattern (one compare per base). Hits overlapping an
+         * exception run are rejected. Calls sink(position, patternId,
+         * length, editDistance) with patternId 0, like KMPMatcher.
+         * @return Number of occurrences delivered (0 if !canSearchPacked)
+         */
+        template <typename Sink>
+        size_t findEach(const std::string& pattern, Sink&& sink) const {
+            uint64_t target;
+            if (!packPattern(pattern, target) || pattern.length() > length_) {
+                return 0;
+            }
+
+            const size_t m = pattern.length();
+            const unsigned topShift = static_cast<unsigned>(2 * (m - 1));
+            const PackedException* runs = exceptions_.data();
+            const size_t runCount = exceptions_.size();
+            size_t nextRun = 0;           // First run ending after the candidate start
+            size_t found = 0;
+            uint64_t window = 0;
+
+            for (size_t w = 0; w < words_.size(); ++w) {
+                uint64_t word = words_[w];
+                size_t base = w * BASES_PER_WORD;
+                size_t count = std::min(BASES_PER_WORD, length_ - base);
+
+                for (size_t k = 0; k < count; ++k, word >>= 2) {
+                    // Oldest base at the bottom, newest at bits 2 * (m - 1)
+                    window = (window >> 2) | ((word & 3u) << topShift);
+
+                    size_t end = base + k + 1;
+                    if (window != target || end < m) {
+                        continue;
+                    }
+
+                    size_t start = end - m;
+                    while (nextRun < runCount && runs[nextRun].end() <= start) {
+                        nextRun++;
+                    }
+                    if (nextRun < runCount && runs[nextRun].start < end) {
+                        continue;
+                    }
+
+                    found++;
+                    if (!detail::emitMatch(sink, start, 0, m, 0)) {
+                        return found;
+                    }
+                }
+            }
+
+            return found;
+        }
+
+        /**
+         * findEach() collecting MatchResult objects
+         */
+        std::vector<MatchResult> find(const std::string& pattern) const;
+
+    private:
+        std::vector<uint64_t> words_;             // Bits past length_ are always 0
+        std::vector<PackedException> exceptions_; // Sorted, non-overlapping
+        size_t length_;
+        bool rna_;
+
+        /**
+         * 32 bases starting at position (bases past the end read as 0)
+         */
+        uint64_t windowAt(size_t position) const;
+
+        /**
+         * Index of the first exception run ending after position
+         */
+        size_t firstRunAfter(size_t position) const;
+
+        /**
+         * Append an exception run, extending the last run if it is adjacent
+         * and holds the same symbol
+         */
+        void addException(size_t start, size_t length, char symbol);
+
+        /**
+         * Overwrite the packed codes of [start, start + length)
+         */
+        void fillCodes(size_t start, size_t length, unsigned code);
+
+        /**
+         * Encode a pattern as a packed word (pattern[0] in the low bits)
+         */
+        bool packPattern(const std::string& pattern, uint64_t& code) const;
+    };
+
+} // namespace DNACore
\ No newline at end of file
@@ -0,0 +1,296 @@
+#include "PositionWeightMatrix.h"
+#include "IUPACCode.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace DNACore {
+
+    namespace {
+
+        /**
+         * Matrix being read by parseJASPAR
+         */
+        struct PendingMatrix {
+            std::string id;
+            std::string name;
+            std::vector<double> rows[4];
+            bool seen[4] = { false, false, false, false };
+            int rowCount = 0;
+            size_t line = 0;                  // Line of the header or first row
+        };
+
+        std::string trim(const std::string& text) {
+            size_t begin = text.find_first_not_of(" \t\r\n");
+            if (begin == std::string::npos) {
+                return "";
+            }
+            size_t end = text.find_last_not_of(" \t\r\n");
+            return text.substr(begin, end - begin + 1);
+        }
+
+        int baseRow(char ch) {
+            switch (ch) {
+            case 'A': case 'a': return 0;
+            case 'C': case 'c': return 1;
+            case 'G': case 'g': return 2;
+            case 'T': case 't': case 'U': case 'u': return 3;
+            default: return -1;
+            }
+        }
+
+        /**
+         * Turn a complete pending matrix into a PositionWeightMatrix
+         * @return false (with a message in errors) if it is malformed
+         */
+        bool finishMatrix(PendingMatrix& pending, size_t index, std::vector<PositionWeightMatrix>& matrices,
+            std::vector<std::string>& errors) {
+
+            if (pending.id.empty()) {
+                pending.id = "matrix" + std::to_string(index + 1);
+            }
+            if (pending.name.empty()) {
+                pending.name = pending.id;
+            }
+            std::string where = "Matrix " + pending.id + " (line " + std::to_string(pending.line) + "): ";
+
+            if (pending.rowCount != 4) {
+                errors.push_back(where + "expected 4 rows, found " + std::to_string(pending.rowCount));
+                return false;
+            }
+
+            size_t length = pending.rows[0].size();
+            for (const auto& row : pending.rows) {
+                if (row.size() != length) {
+                    errors.push_back(where + "rows have different lengths");
+                    return false;
+                }
+            }
+            if (length == 0 || length > PositionWeightMatrix::MAX_LENGTH) {
+                errors.push_back(where + "length " + std::to_string(length) + " outside 1-" +
+                    std::to_string(PositionWeightMatrix::MAX_LENGTH));
+                return false;
+            }
+
+            std::vector<PositionWeightMatrix::Column> counts(length);
+            for (size_t j = 0; j < length; ++j) {
+                double total = 0.0;
+                for (int b = 0; b < 4; ++b) {
+                    double value = pending.rows[b][j];
+                    if (!(value >= 0.0)) {
+                        errors.push_back(where + "negative or invalid count");
+                        return false;
+                    }
+                    counts[j][b] = value;
+                    total += value;
+                }
+                if (total <= 0.0) {
+                    errors.push_back(where + "position " + std::to_string(j + 1) + " has no counts");
+                    return false;
+                }
+            }
+
+            matrices.emplace_back(pending.id, pending.name, counts);
+            return true;
+        }
+
+    } // namespace
+
+    PositionWeightMatrix::PositionWeightMatrix() {
+    }
+
+    PositionWeightMatrix::PositionWeightMatrix(const std::string& id, const std::string& name,
+        const std::vector<Column>& counts)
+        : id_(id), name_(name), counts_(counts) {
+    }
+
+    PositionWeightMatrix::~PositionWeightMatrix() {
+    }
+
+    PositionWeightMatrix PositionWeightMatrix::fromConsensus(const std::string& id, const std::string& name,
+        const std::string& pattern, double sites) {
+
+        if (pattern.empty() || pattern.length() > MAX_LENGTH) {
+            return PositionWeightMatrix();
+        }
+
+        std::vector<Column> counts(pattern.length());
+        for (size_t j = 0; j < pattern.length(); ++j) {
+            unsigned mask = IUPACCode::baseMask(pattern[j]);
+            if (mask == 0) {
+                return PositionWeightMatrix();
+            }
+
+            int bases = 0;
+            for (int b = 0; b < 4; ++b) {
+                bases += (mask >> b) & 1u;
+            }
+            for (int b = 0; b < 4; ++b) {
+                counts[j][b] = ((mask >> b) & 1u) ? sites / bases : 0.0;
+            }
+        }
+
+        return PositionWeightMatrix(id, name, counts);
+    }
+
+    std::string PositionWeightMatrix::consensus() const {
+        // Base masks back to codes: bit 0 = A, 1 = C, 2 = G, 3 = T
+        static const char CODES[16] = {
+            'N', 'A', 'C', 'M', 'G', 'R', 'S', 'V', 'T', 'W', 'Y', 'H', 'K', 'D', 'B', 'N'
+        };
+
+        std::string result;
+        for (const auto& column : counts_) {
+            double best = *std::max_element(column.begin(), column.end());
+            unsigned mask = 0;
+            for (int b = 0; b < 4; ++b) {
+                if (column[b] == best) {
+                    mask |= 1u << b;
+                }
+            }
+            result += CODES[mask];
+        }
+        return result;
+    }
+
+    std::vector<std::array<int, 4>> PositionWeightMatrix::logOdds(const Column& background,
+        double pseudocount) const {
+
+        std::vector<std::array<int, 4>> scores(counts_.size());
+
+        for (size_t j = 0; j < counts_.size(); ++j) {
+            const Column& column = counts_[j];
+            double total = column[0] + column[1] + column[2] + column[3];
+
+            for (int b = 0; b < 4; ++b) {
+                double p = (column[b] + pseudocount * background[b]) / (total + pseudocount);
+                int score = MIN_COLUMN_SCORE;
+                if (p > 0.0 && background[b] > 0.0) {
+                    double bits = std::log2(p / background[b]);
+                    score = static_cast<int>(std::lround(bits * SCORE_SCALE));
+                }
+                scores[j][b] = std::max(score, MIN_COLUMN_SCORE);
+            }
+        }
+
+        return scores;
+    }
+
+    // ===== LOADING =====
+
+    std::vector<PositionWeightMatrix> PositionWeightMatrix::parseJASPAR(const std::string& content,
+        std::vector<std::string>& errors) {
+
+        std::vector<PositionWeightMatrix> matrices;
+        PendingMatrix pending;
+        size_t attempted = 0;
+        bool open = false;
+
+        auto flush = [&]() {
+            if (open) {
+                finishMatrix(pending, attempted++, matrices, errors);
+            }
+            pending = PendingMatrix();
+            open = false;
+        };
+
+        std::istringstream input(content);
+        std::string rawLine;
+        size_t lineNumber = 0;
+
+        while (std::getline(input, rawLine)) {
+            lineNumber++;
+            std::string line = trim(rawLine);
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+
+            if (line[0] == '>') {
+                flush();
+
+                // ">MA0004.1 Arnt": identifier, then the rest as the name
+                std::string header = trim(line.substr(1));
+                size_t split = header.find_first_of(" \t");
+                pending.id = header.substr(0, split);
+                pending.name = split == std::string::npos ? pending.id : trim(header.substr(split));
+                pending.line = lineNumber;
+                open = true;
+                continue;
+            }
+
+            // A fifth row starts the next header-less matrix
+            if (open && pending.rowCount == 4) {
+                flush();
+            }
+
+            if (!open) {
+                pending.line = lineNumber;
+                open = true;
+            }
+
+            // Optional base letter, then numbers with optional brackets
+            int row = pending.rowCount;
+            size_t pos = 0;
+            if (baseRow(line[0]) >= 0 && (line.size() == 1 || !std::isdigit(static_cast<unsigned char>(line[1])))) {
+                row = baseRow(line[0]);
+                pos = 1;
+            }
+
+            if (pending.seen[row]) {
+                errors.push_back("Line " + std::to_string(lineNumber) + ": unexpected matrix row");
+                continue;
+            }
+
+            std::replace(line.begin(), line.end(), '[', ' ');
+            std::replace(line.begin(), line.end(), ']', ' ');
+
+            const char* cursor = line.c_str() + pos;
+            std::vector<double>& values = pending.rows[row];
+            bool valid = true;
+            while (true) {
+                while (*cursor == ' ' || *cursor == '\t') {
+                    ++cursor;
+                }
+                if (*cursor == '\0') {
+                    break;
+                }
+                char* end = nullptr;
+                double value = std::strtod(cursor, &end);
+                if (end == cursor) {
+                    valid = false;
+                    break;
+                }
+                values.push_back(value);
+                cursor = end;
+            }
+
+            if (!valid) {
+                errors.push_back("Line " + std::to_string(lineNumber) + ": invalid number");
+            }
+
+            pending.seen[row] = true;
+            pending.rowCount++;
+        }
+
+        flush();
+        return matrices;
+    }
+
+    std::vector<PositionWeightMatrix> PositionWeightMatrix::loadJASPAR(const std::string& path,
+        std::vector<std::string>& errors) {
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            errors.push_back("Failed to open file: " + path);
+            return {};
+        }
+
+        std::ostringstream content;
+        content << file.rdbuf();
+        return parseJASPAR(content.str(), errors);
+    }
+
+} // namespace DNACore
\ No newline at end of file
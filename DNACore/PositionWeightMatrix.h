@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace DNACore {
+
+    /**
+     * Position weight matrix: base counts (or frequencies) per motif
+     * position, in A, C, G, T order
+     * Scores are log-odds against a background, in integer units of
+     * 1 / SCORE_SCALE bits, so windows can be summed exactly in 16-bit
+     * lanes and score distributions computed by dynamic programming.
+     */
+    class PositionWeightMatrix {
+    public:
+        typedef std::array<double, 4> Column;
+
+        // Longest matrix accepted
+        static constexpr size_t MAX_LENGTH = 64;
+
+        // Integer score units per bit
+        static constexpr int SCORE_SCALE = 32;
+
+        // Column scores are clamped here (-8 bits), keeping window sums in 16 bits
+        static constexpr int MIN_COLUMN_SCORE = -8 * SCORE_SCALE;
+
+        // Total pseudocount added to each column, spread by the background
+        static constexpr double DEFAULT_PSEUDOCOUNT = 0.8;
+
+        PositionWeightMatrix();
+        PositionWeightMatrix(const std::string& id, const std::string& name, const std::vector<Column>& counts);
+        ~PositionWeightMatrix();
+
+        /**
+         * Matrix for an IUPAC consensus string: each position splits
+         * `sites` counts evenly over the bases its code stands for
+         * @return Empty matrix if the pattern has other characters
+         */
+        static PositionWeightMatrix fromConsensus(const std::string& id, const std::string& name,
+            const std::string& pattern, double sites = 20.0);
+
+        const std::string& getId() const { return id_; }
+        const std::string& getName() const { return name_; }
+        const std::vector<Column>& getCounts() const { return counts_; }
+
+        size_t length() const { return counts_.size(); }
+        bool empty() const { return counts_.empty(); }
+
+        /**
+         * Most frequent base per position, as an IUPAC code when two or
+         * three bases tie (N when all four do)
+         */
+        std::string consensus() const;
+
+        /**
+         * Integer log-odds per position and base:
+         * round(SCORE_SCALE * log2(p(base) / background(base))), with
+         * p(base) = (count + pseudocount * background) / (total + pseudocount)
+         * and never below MIN_COLUMN_SCORE
+         */
+        std::vector<std::array<int, 4>> logOdds(const Column& background,
+            double pseudocount = DEFAULT_PSEUDOCOUNT) const;
+
+        // ===== LOADING =====
+
+        /**
+         * Parse matrices in JASPAR format: a ">ID name" header followed by
+         * rows "A [ 4 19 0 ... ]" for A, C, G and T (letters and brackets
+         * optional). Bad matrices are skipped with a message in errors.
+         */
+        static std::vector<PositionWeightMatrix> parseJASPAR(const std::string& content,
+            std::vector<std::string>& errors);
+
+        /**
+         * Read a JASPAR file (see parseJASPAR)
+         */
+        static std::vector<PositionWeightMatrix> loadJASPAR(const std::string& path,
+            std::vector<std::string>& errors);
+
+    private:
+        std::string id_;
+        std::string name_;
+        std::vector<Column> counts_;
+    };
+
+} // namespace DNACore
\ No newline at end of file
@@ -146,8 +146,10 @@ namespace DNACore {
                 }
                 // ALWAYS POP the bottom marker '$'
                 notifyPop('$', start);
-                notifyMatchRejected(start,
-                    std::string("Mismatch: expected ") + patternChar + ", got " + textChar);
+                if (!observers_.empty()) {
+                    notifyMatchRejected(start,
+                        std::string("Mismatch: expected ") + patternChar + ", got " + textChar);
+                }
                 return false;
             }
 
@@ -173,7 +175,9 @@ namespace DNACore {
         notifyPop('$', start);
         
         // THEN notify match found (so POPs appear before "MATCH ACCEPTED")
-        notifyMatchFound(start, text.substr(start, pattern.length()));
+        if (!observers_.empty()) {
+            notifyMatchFound(start, text.substr(start, pattern.length()));
+        }
 
         return true;
     }
@@ -181,38 +185,16 @@ namespace DNACore {
     std::vector<MatchResult> PushdownAutomaton::search(const std::string& text, const std::string& pattern) {
         std::vector<MatchResult> results;
 
-        notifyAnalysisStart(text, pattern);
-
-        if (pattern.empty() || text.empty()) {
-            notifyAnalysisComplete(0);
-            return results;
-        }
-
-        size_t n = text.length();
-        size_t m = pattern.length();
-
-        if (m > n) {
-            notifyAnalysisComplete(0);
-            return results;
-        }
-
-        // Search at all valid positions
-        for (size_t i = 0; i <= n - m; ++i) {
-            reset();  // Reset stack and state for each new position
-
-            if (matchWithStack(text, i, pattern)) {
-                results.emplace_back(
-                    i,
-                    text.substr(i, m),
-                    0,
-                    "PDA Match",
-                    "PDA"
-                );
-                // notifyMatchFound is now called inside matchWithStack
-            }
-        }
+        searchEach(text, pattern, [&](size_t position, int, size_t length, int editDistance) {
+            results.emplace_back(
+                position,
+                text.substr(position, length),
+                editDistance,
+                "PDA Match",
+                "PDA"
+            );
+        });
 
-        notifyAnalysisComplete(results.size());
         return results;
     }
 
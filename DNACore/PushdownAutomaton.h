@@ -25,6 +25,43 @@ namespace DNACore {
          */
         std::vector<MatchResult> search(const std::string& text, const std::string& pattern);
 
+        /**
+         * Allocation-free search: calls sink(position, patternId, length,
+         * editDistance) for every match (patternId is always 0). Observers
+         * are still notified; trace strings are only built when at least
+         * one observer is attached.
+         * @return Number of matches delivered before the sink stopped
+         */
+        template <typename Sink>
+        size_t searchEach(const std::string& text, const std::string& pattern, Sink&& sink) {
+            notifyAnalysisStart(text, pattern);
+
+            if (pattern.empty() || text.empty() || pattern.length() > text.length()) {
+                notifyAnalysisComplete(0);
+                return 0;
+            }
+
+            size_t n = text.length();
+            size_t m = pattern.length();
+            size_t found = 0;
+
+            // Search at all valid positions
+            for (size_t i = 0; i <= n - m; ++i) {
+                reset();  // Reset stack and state for each new position
+
+                if (matchWithStack(text, i, pattern)) {
+                    // notifyMatchFound is called inside matchWithStack
+                    found++;
+                    if (!detail::emitMatch(sink, i, 0, m, 0)) {
+                        break;
+                    }
+                }
+            }
+
+            notifyAnalysisComplete(found);
+            return found;
+        }
+
         /**
          * Observer management
          */
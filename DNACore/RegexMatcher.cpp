@@ -0,0 +1,1171 @@
+#include "RegexMatcher.h"
+#include "CompositionKernel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <map>
+#include <sstream>
+
+namespace DNACore {
+
+    namespace {
+
+        // ===== SYNTAX TREE =====
+
+        enum NodeType {
+            NODE_SET,         // One byte from a character set
+            NODE_CONCAT,
+            NODE_ALTERNATE,
+            NODE_REPEAT,      // child{min,max}, max < 0 for unbounded
+            NODE_EMPTY
+        };
+
+        struct Node {
+            NodeType type;
+            int set;
+            std::vector<int> children;
+            int min;
+            int max;
+        };
+
+        /**
+         * Recursive-descent parser:
+         *   alternation := concat ('|' concat)*
+         *   concat      := repeat*
+         *   repeat      := atom ('*' | '+' | '?' | '{n}' | '{n,}' | '{n,m}')*
+         *   atom        := '(' alternation ')' | '[' class ']' | '.' | '\' byte | byte
+         */
+        class Parser {
+        public:
+            Parser(const std::string& pattern, std::vector<std::bitset<256>>& sets, std::vector<Node>& nodes)
+                : pattern_(pattern), sets_(sets), nodes_(nodes), pos_(0), depth_(0) {
+            }
+
+            /**
+             * @return Root node, or -1 with error set
+             */
+            int parse(std::string& error) {
+                int root = parseAlternation();
+                if (error_.empty() && pos_ < pattern_.length()) {
+                    fail("Unmatched ')'");
+                }
+                if (!error_.empty()) {
+                    error = error_;
+                    return -1;
+                }
+                return root;
+            }
+
+        private:
+            const std::string& pattern_;
+            std::vector<std::bitset<256>>& sets_;
+            std::vector<Node>& nodes_;
+            size_t pos_;
+            int depth_;
+            std::string error_;
+
+            // Deeper nesting would overflow the stack while compiling
+            static constexpr int MAX_DEPTH = 1000;
+
+            bool atEnd() const { return pos_ >= pattern_.length(); }
+            char peek() const { return pattern_[pos_]; }
+
+            int fail(const std::string& message) {
+                if (error_.empty()) {
+                    error_ = message + " at position " + std::to_string(pos_);
+                }
+                return -1;
+            }
+
+            int addNode(NodeType type, int set = -1, int min = 0, int max = 0) {
+                nodes_.push_back(Node{ type, set, {}, min, max });
+                return static_cast<int>(nodes_.size()) - 1;
+            }
+
+            int addSet(const std::bitset<256>& set) {
+                for (size_t i = 0; i < sets_.size(); ++i) {
+                    if (sets_[i] == set) {
+                        return addNode(NODE_SET, static_cast<int>(i));
+                    }
+                }
+                sets_.push_back(set);
+                return addNode(NODE_SET, static_cast<int>(sets_.size()) - 1);
+            }
+
+            int parseAlternation() {
+                int first = parseConcat();
+                if (first < 0 || atEnd() || peek() != '|') {
+                    return first;
+                }
+
+                int node = addNode(NODE_ALTERNATE);
+                nodes_[node].children.push_back(first);
+                while (!atEnd() && peek() == '|') {
+                    pos_++;
+                    int branch = parseConcat();
+                    if (branch < 0) {
+                        return -1;
+                    }
+                    nodes_[node].children.push_back(branch);
+                }
+                return node;
+            }
+
+            int parseConcat() {
+                std::vector<int> items;
+                while (!atEnd() && peek() != '|' && peek() != ')') {
+                    int item = parseRepeat();
+                    if (item < 0) {
+                        return -1;
+                    }
+                    items.push_back(item);
+                }
+
+                if (items.empty()) {
+                    return addNode(NODE_EMPTY);
+                }
+                if (items.size() == 1) {
+                    return items[0];
+                }
+                int node = addNode(NODE_CONCAT);
+                nodes_[node].children = std::move(items);
+                return node;
+            }
+
+            int parseRepeat() {
+                int atom = parseAtom();
+                int stacked = 0;
+                while (atom >= 0 && !atEnd()) {
+                    int min;
+                    int max;
+                    char c = peek();
+                    if (c == '*') {
+                        min = 0;
+                        max = -1;
+                        pos_++;
+                    }
+                    else if (c == '+') {
+                        min = 1;
+                        max = -1;
+                        pos_++;
+                    }
+                    else if (c == '?') {
+                        min = 0;
+                        max = 1;
+                        pos_++;
+                    }
+                    else if (c == '{') {
+                        if (!parseCount(min, max)) {
+                            return -1;
+                        }
+                    }
+                    else {
+                        break;
+                    }
+                    if (++stacked > MAX_DEPTH) {
+                        return fail("Repeats nested too deeply");
+                    }
+
+                    int node = addNode(NODE_REPEAT, -1, min, max);
+                    nodes_[node].children.push_back(atom);
+                    atom = node;
+                }
+                return atom;
+            }
+
+            bool parseNumber(int& value) {
+                size_t begin = pos_;
+                value = 0;
+                while (!atEnd() && peek() >= '0' && peek() <= '9') {
+                    value = value * 10 + (peek() - '0');
+                    if (value > RegexMatcher::MAX_REPEAT) {
+                        fail("Repeat count above " + std::to_string(RegexMatcher::MAX_REPEAT));
+                        return false;
+                    }
+                    pos_++;
+                }
+                return pos_ > begin;
+            }
+
+            /**
+             * {n}, {n,} or {n,m} at pos_
+             */
+            bool parseCount(int& min, int& max) {
+                size_t begin = pos_++;
+                if (!parseNumber(min)) {
+                    pos_ = begin;
+                    fail("Invalid repeat count");
+                    return false;
+                }
+
+                max = min;
+                if (!atEnd() && peek() == ',') {
+                    pos_++;
+                    max = -1;
+                    if (!atEnd() && peek() != '}' && !parseNumber(max)) {
+                        pos_ = begin;
+                        fail("Invalid repeat count");
+                        return false;
+                    }
+                }
+                if (!error_.empty()) {
+                    return false;
+                }
+                if (atEnd() || peek() != '}') {
+                    pos_ = begin;
+                    fail("Unterminated repeat count");
+                    return false;
+                }
+                pos_++;
+
+                if (max >= 0 && max < min) {
+                    pos_ = begin;
+                    fail("Repeat maximum below minimum");
+                    return false;
+                }
+                return true;
+            }
+
+            int parseAtom() {
+                char c = peek();
+                std::bitset<256> set;
+
+                switch (c) {
+                case '(': {
+                    if (++depth_ > MAX_DEPTH) {
+                        return fail("Groups nested too deeply");
+                    }
+                    size_t open = pos_++;
+                    int inner = parseAlternation();
+                    if (inner < 0) {
+                        return -1;
+                    }
+                    if (atEnd()) {
+                        pos_ = open;
+                        return fail("Unmatched '('");
+                    }
+                    pos_++;
+                    depth_--;
+                    return inner;
+                }
+                case '[':
+                    return parseClass();
+                case '.':
+                    pos_++;
+                    set.set();
+                    return addSet(set);
+                case '*':
+                case '+':
+                case '?':
+                case '{':
+                    return fail("Nothing to repeat");
+                case '^':
+                case '$':
+                    return fail("Anchors are not supported");
+                case '\\':
+                    if (pos_ + 1 >= pattern_.length()) {
+                        return fail("Trailing backslash");
+                    }
+                    pos_++;
+                    c = peek();
+                    break;
+                default:
+                    break;
+                }
+
+                pos_++;
+                set.set(static_cast<unsigned char>(c));
+                return addSet(set);
+            }
+
+            int parseClass() {
+                size_t open = pos_++;
+                bool negate = !atEnd() && peek() == '^';
+                if (negate) {
+                    pos_++;
+                }
+
+                std::bitset<256> set;
+                bool first = true;
+                while (!atEnd() && (peek() != ']' || first)) {
+                    first = false;
+                    unsigned char low;
+                    if (!classByte(low)) {
+                        return -1;
+                    }
+
+                    unsigned char high = low;
+                    if (pos_ + 1 < pattern_.length() && peek() == '-' && pattern_[pos_ + 1] != ']') {
+                        pos_++;
+                        if (!classByte(high)) {
+                            return -1;
+                        }
+                        if (high < low) {
+                            return fail("Invalid class range");
+                        }
+                    }
+                    for (unsigned b = low; b <= high; ++b) {
+                        set.set(b);
+                    }
+                }
+
+                if (atEnd()) {
+                    pos_ = open;
+                    return fail("Unmatched '['");
+                }
+                pos_++;
+
+                if (negate) {
+                    set.flip();
+                }
+                if (set.none()) {
+                    pos_ = open;
+                    return fail("Empty character class");
+                }
+                return addSet(set);
+            }
+
+            bool classByte(unsigned char& b) {
+                if (peek() == '\\') {
+                    if (pos_ + 1 >= pattern_.length()) {
+                        fail("Trailing backslash");
+                        return false;
+                    }
+                    pos_++;
+                }
+                b = static_cast<unsigned char>(peek());
+                pos_++;
+                return true;
+            }
+        };
+
+        // ===== THOMPSON CONSTRUCTION =====
+
+        struct EmittedState {
+            int type;         // RegexMatcher::StateType
+            int set;
+            int out;
+            int out1;
+        };
+
+        /**
+         * Emit NFA states for a syntax tree, back to front: every fragment is
+         * built knowing the state it continues to. With reversed set,
+         * concatenations are emitted in the opposite order, giving an NFA
+         * for the pattern read right to left.
+         */
+        class Emitter {
+        public:
+            Emitter(const std::vector<Node>& nodes, bool reversed, int charType, int splitType)
+                : nodes_(nodes), reversed_(reversed), charType_(charType), splitType_(splitType),
+                overflow_(false) {
+            }
+
+            std::vector<EmittedState> states;
+
+            bool overflowed() const { return overflow_; }
+
+            int add(int type, int set, int out, int out1) {
+                if (states.size() >= RegexMatcher::MAX_NFA_STATES) {
+                    overflow_ = true;
+                    return 0;
+                }
+                states.push_back(EmittedState{ type, set, out, out1 });
+                return static_cast<int>(states.size()) - 1;
+            }
+
+            int emit(int index, int next) {
+                if (overflow_) {
+                    return 0;
+                }
+
+                const Node& node = nodes_[index];
+                switch (node.type) {
+                case NODE_SET:
+                    return add(charType_, node.set, next, -1);
+
+                case NODE_CONCAT:
+                    if (reversed_) {
+                        for (int child : node.children) {
+                            next = emit(child, next);
+                        }
+                    }
+                    else {
+                        for (size_t i = node.children.size(); i-- > 0;) {
+                            next = emit(node.children[i], next);
+                        }
+                    }
+                    return next;
+
+                case NODE_ALTERNATE: {
+                    int entry = emit(node.children.back(), next);
+                    for (size_t i = node.children.size() - 1; i-- > 0;) {
+                        int branch = emit(node.children[i], next);
+                        entry = add(splitType_, -1, branch, entry);
+                    }
+                    return entry;
+                }
+
+                case NODE_REPEAT: {
+                    int child = node.children[0];
+                    int entry = next;
+                    if (node.max < 0) {
+                        // child* : a split that loops back through the child
+                        int loop = add(splitType_, -1, -1, next);
+                        int body = emit(child, loop);
+                        if (overflow_) {
+                            return 0;
+                        }
+                        states[loop].out = body;
+                        entry = loop;
+                    }
+                    else {
+                        // (child(child(...)?)?)? with max - min copies
+                        for (int i = node.min; i < node.max && !overflow_; ++i) {
+                            int body = emit(child, entry);
+                            entry = add(splitType_, -1, body, next);
+                        }
+                    }
+                    for (int i = 0; i < node.min && !overflow_; ++i) {
+                        entry = emit(child, entry);
+                    }
+                    return entry;
+                }
+
+                case NODE_EMPTY:
+                default:
+                    return next;
+                }
+            }
+
+        private:
+            const std::vector<Node>& nodes_;
+            bool reversed_;
+            int charType_;
+            int splitType_;
+            bool overflow_;
+        };
+
+        // ===== LITERAL ANALYSIS =====
+
+        constexpr size_t UNBOUNDED = std::numeric_limits<size_t>::max();
+
+        // Largest literal set kept while combining nodes
+        constexpr size_t MAX_LITERAL_SET = 16;
+
+        constexpr size_t MAX_LITERAL_LENGTH = 64;
+
+        // Classes up to this size are expanded into literals
+        constexpr size_t MAX_CLASS_LITERALS = 4;
+
+        // The prefilter is skipped when literal windows would cover more
+        // than this fraction of a random sequence
+        constexpr double MAX_WINDOW_COVERAGE = 0.5;
+
+        // Substring shared by a literal set, long enough to scan for instead
+        constexpr size_t MIN_COMMON_LITERAL = 4;
+
+        struct LiteralInfo {
+            bool exact = false;
+            std::vector<std::string> strings;     // The node's whole language, if exact
+            std::vector<std::string> cover;       // Every match contains one of these (empty: unknown)
+            size_t minLength = 0;
+            size_t maxLength = 0;                 // UNBOUNDED after * or +
+        };
+
+        size_t addLengths(size_t a, size_t b) {
+            return (a == UNBOUNDED || b == UNBOUNDED || a > UNBOUNDED - b) ? UNBOUNDED : a + b;
+        }
+
+        size_t multiplyLength(size_t length, size_t count) {
+            if (length == 0 || count == 0) {
+                return 0;
+            }
+            return (length == UNBOUNDED || count == UNBOUNDED || length > UNBOUNDED / count)
+                ? UNBOUNDED : length * count;
+        }
+
+        /**
+         * Expected hits per base of a literal set in uniform random DNA
+         */
+        double literalDensity(const std::vector<std::string>& literals) {
+            double density = 0.0;
+            for (const auto& literal : literals) {
+                density += std::pow(0.25, static_cast<double>(literal.length()));
+            }
+            return density;
+        }
+
+        void sortUnique(std::vector<std::string>& strings) {
+            std::sort(strings.begin(), strings.end());
+            strings.erase(std::unique(strings.begin(), strings.end()), strings.end());
+        }
+
+        /**
+         * Every concatenation of a string of a with one of b, if it fits
+         */
+        bool literalProduct(const std::vector<std::string>& a, const std::vector<std::string>& b,
+            std::vector<std::string>& out) {
+            if (a.size() * b.size() > MAX_LITERAL_SET) {
+                return false;
+            }
+            out.clear();
+            for (const auto& left : a) {
+                for (const auto& right : b) {
+                    if (left.length() + right.length() > MAX_LITERAL_LENGTH) {
+                        return false;
+                    }
+                    out.push_back(left + right);
+                }
+            }
+            sortUnique(out);
+            return true;
+        }
+
+        /**
+         * Keep candidate as the cover if it is valid and rarer than the current one
+         */
+        void offerCover(LiteralInfo& info, const std::vector<std::string>& candidate) {
+            if (candidate.empty()) {
+                return;
+            }
+            for (const auto& literal : candidate) {
+                if (literal.empty()) {
+                    return;
+                }
+            }
+            if (info.cover.empty() || literalDensity(candidate) < literalDensity(info.cover)) {
+                info.cover = candidate;
+            }
+        }
+
+        LiteralInfo analyzeLiterals(const std::vector<Node>& nodes, const std::vector<std::bitset<256>>& sets,
+            int index) {
+            const Node& node = nodes[index];
+            LiteralInfo info;
+
+            switch (node.type) {
+            case NODE_SET: {
+                info.minLength = info.maxLength = 1;
+                const auto& set = sets[node.set];
+                if (set.count() <= MAX_CLASS_LITERALS) {
+                    info.exact = true;
+                    for (unsigned b = 0; b < 256; ++b) {
+                        if (set.test(b)) {
+                            info.strings.push_back(std::string(1, static_cast<char>(b)));
+                        }
+                    }
+                    info.cover = info.strings;
+                }
+                break;
+            }
+
+            case NODE_CONCAT: {
+                // Consecutive exact children combine into longer literals
+                info.exact = true;
+                info.strings.assign(1, std::string());
+                std::vector<std::string> run;
+                std::vector<std::string> joined;
+
+                for (int child : node.children) {
+                    LiteralInfo part = analyzeLiterals(nodes, sets, child);
+                    info.minLength = addLengths(info.minLength, part.minLength);
+                    info.maxLength = addLengths(info.maxLength, part.maxLength);
+                    offerCover(info, part.cover);
+
+                    if (info.exact && part.exact && literalProduct(info.strings, part.strings, joined)) {
+                        info.strings.swap(joined);
+                    }
+                    else {
+                        info.exact = false;
+                    }
+
+                    if (!part.exact) {
+                        run.clear();
+                        continue;
+                    }
+                    if (!run.empty() && literalProduct(run, part.strings, joined)) {
+                        run.swap(joined);
+                    }
+                    else {
+                        run = part.strings;
+                    }
+                    offerCover(info, run);
+                }
+
+                if (!info.exact) {
+                    info.strings.clear();
+                }
+                break;
+            }
+
+            case NODE_ALTERNATE: {
+                info.exact = true;
+                info.minLength = UNBOUNDED;
+                bool covered = true;
+
+                for (int child : node.children) {
+                    LiteralInfo part = analyzeLiterals(nodes, sets, child);
+                    info.minLength = std::min(info.minLength, part.minLength);
+                    info.maxLength = std::max(info.maxLength, part.maxLength);
+
+                    info.exact = info.exact && part.exact;
+                    if (info.exact) {
+                        info.strings.insert(info.strings.end(), part.strings.begin(), part.strings.end());
+                    }
+                    covered = covered && !part.cover.empty();
+                    if (covered) {
+                        info.cover.insert(info.cover.end(), part.cover.begin(), part.cover.end());
+                    }
+                }
+
+                sortUnique(info.strings);
+                sortUnique(info.cover);
+                if (!info.exact || info.strings.size() > MAX_LITERAL_SET) {
+                    info.exact = false;
+                    info.strings.clear();
+                }
+                if (!covered || info.cover.size() > MAX_LITERAL_SET) {
+                    info.cover.clear();
+                }
+                break;
+            }
+
+            case NODE_REPEAT: {
+                LiteralInfo part = analyzeLiterals(nodes, sets, node.children[0]);
+                info.minLength = multiplyLength(part.minLength, static_cast<size_t>(node.min));
+                info.maxLength = multiplyLength(part.maxLength,
+                    node.max < 0 ? UNBOUNDED : static_cast<size_t>(node.max));
+
+                // Exact when the child is exact and the powers stay small
+                std::vector<std::string> power(1, std::string());
+                std::vector<std::string> joined;
+                bool exact = part.exact && node.max >= 0;
+                if (exact && node.min == 0) {
+                    info.strings.push_back(std::string());
+                }
+                for (int k = 1; exact && k <= node.max; ++k) {
+                    exact = literalProduct(power, part.strings, joined);
+                    power.swap(joined);
+                    if (k >= node.min) {
+                        info.strings.insert(info.strings.end(), power.begin(), power.end());
+                        exact = exact && info.strings.size() <= MAX_LITERAL_SET;
+                    }
+                }
+                info.exact = exact;
+                if (exact) {
+                    sortUnique(info.strings);
+                }
+                else {
+                    info.strings.clear();
+                }
+
+                if (node.min >= 1) {
+                    offerCover(info, part.cover);
+
+                    // child{n,...} always starts with n copies of the child
+                    power.assign(1, std::string());
+                    bool fits = part.exact;
+                    for (int k = 0; fits && k < node.min; ++k) {
+                        fits = literalProduct(power, part.strings, joined);
+                        power.swap(joined);
+                    }
+                    if (fits) {
+                        offerCover(info, power);
+                    }
+                }
+                if (info.exact) {
+                    offerCover(info, info.strings);
+                }
+                break;
+            }
+
+            case NODE_EMPTY:
+            default:
+                info.exact = true;
+                info.strings.assign(1, std::string());
+                break;
+            }
+
+            return info;
+        }
+
+        /**
+         * Longest string contained in every literal (first found on ties)
+         */
+        std::string commonSubstring(const std::vector<std::string>& literals) {
+            const std::string& first = literals.front();
+            for (size_t length = first.length(); length > 0; --length) {
+                for (size_t start = 0; start + length <= first.length(); ++start) {
+                    std::string candidate = first.substr(start, length);
+                    bool shared = true;
+                    for (const auto& literal : literals) {
+                        if (literal.find(candidate) == std::string::npos) {
+                            shared = false;
+                            break;
+                        }
+                    }
+                    if (shared) {
+                        return candidate;
+                    }
+                }
+            }
+            return std::string();
+        }
+
+        /**
+         * Hash key of a DFA state: match flag, then the raw NFA state ids
+         */
+        std::string stateKey(const std::vector<int>& set, bool match) {
+            std::string key(1, match ? '\1' : '\0');
+            key.append(reinterpret_cast<const char*>(set.data()), set.size() * sizeof(int));
+            return key;
+        }
+
+        std::string formatByte(unsigned b) {
+            if (b >= 0x21 && b < 0x7f) {
+                return std::string(1, static_cast<char>(b));
+            }
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\x%02X", b);
+            return buffer;
+        }
+
+        std::string formatClassByte(unsigned b) {
+            return (b == ']' || b == '\\' || b == '^' || b == '-') ? "\\" + formatByte(b) : formatByte(b);
+        }
+
+        /**
+         * 'A', '.', [ACG], [A-F] or [^N]
+         */
+        std::string formatSet(const std::bitset<256>& set) {
+            if (set.all()) {
+                return ".";
+            }
+            if (set.count() == 1) {
+                for (unsigned b = 0; b < 256; ++b) {
+                    if (set.test(b)) {
+                        return "'" + formatByte(b) + "'";
+                    }
+                }
+            }
+
+            bool negate = set.count() > 128;
+            std::bitset<256> shown = negate ? ~set : set;
+            std::string text = negate ? "[^" : "[";
+            for (unsigned b = 0; b < 256; ++b) {
+                if (!shown.test(b)) {
+                    continue;
+                }
+                unsigned last = b;
+                while (last + 1 < 256 && shown.test(last + 1)) {
+                    last++;
+                }
+                text += formatClassByte(b);
+                if (last >= b + 2) {
+                    text += "-" + formatClassByte(last);
+                    b = last;
+                }
+            }
+            return text + "]";
+        }
+
+    } // namespace
+
+    RegexMatcher::RegexMatcher()
+        : classCount_(0), maxCachedStates_(DEFAULT_CACHED_STATES), generation_(0),
+          statesBuilt_(0), cacheFlushes_(0), bytesScanned_(0), shortestLiteral_(0),
+          maxMatchLength_(0), prefilterEnabled_(true), candidates_(0) {
+        std::fill(classOf_, classOf_ + 256, static_cast<uint8_t>(0));
+    }
+
+    RegexMatcher::~RegexMatcher() {
+    }
+
+    // ===== COMPILATION =====
+
+    bool RegexMatcher::compile(const std::string& pattern) {
+        pattern_ = pattern;
+        error_.clear();
+        charSets_.clear();
+        forward_ = Program();
+        reverse_ = Program();
+        statesBuilt_ = 0;
+        cacheFlushes_ = 0;
+        bytesScanned_ = 0;
+        choosePrefilter({});
+
+        if (pattern.empty()) {
+            error_ = "Empty pattern";
+            return false;
+        }
+
+        std::vector<Node> nodes;
+        int root = Parser(pattern, charSets_, nodes).parse(error_);
+        if (root < 0) {
+            return false;
+        }
+
+        Program* programs[2] = { &forward_, &reverse_ };
+        for (int direction = 0; direction < 2; ++direction) {
+            Emitter emitter(nodes, direction == 1, STATE_CHAR, STATE_SPLIT);
+            int accept = emitter.add(STATE_MATCH, -1, -1, -1);
+            int start = emitter.emit(root, accept);
+            if (emitter.overflowed()) {
+                error_ = "Pattern compiles to more than " + std::to_string(MAX_NFA_STATES) + " NFA states";
+                forward_ = Program();
+                reverse_ = Program();
+                return false;
+            }
+
+            Program& program = *programs[direction];
+            program.start = start;
+            program.states.reserve(emitter.states.size());
+            for (const EmittedState& s : emitter.states) {
+                program.states.push_back(NFAState{ static_cast<StateType>(s.type), s.set, s.out, s.out1 });
+            }
+        }
+
+        LiteralInfo literals = analyzeLiterals(nodes, charSets_, root);
+        maxMatchLength_ = literals.maxLength;
+        choosePrefilter(literals.cover);
+
+        buildByteClasses();
+        mark_.assign(std::max(forward_.states.size(), reverse_.states.size()), 0);
+        generation_ = 0;
+        resetDFA(forwardDFA_, forward_, false);
+        resetDFA(reverseDFA_, reverse_, true);
+        return true;
+    }
+
+    void RegexMatcher::buildByteClasses() {
+        // Refine one partition of all bytes by each character set in turn
+        std::fill(classOf_, classOf_ + 256, static_cast<uint8_t>(0));
+        classCount_ = 1;
+
+        for (const auto& set : charSets_) {
+            std::map<std::pair<int, bool>, int> renumber;
+            uint8_t refined[256];
+            for (unsigned b = 0; b < 256; ++b) {
+                auto key = std::make_pair(static_cast<int>(classOf_[b]), static_cast<bool>(set.test(b)));
+                auto it = renumber.emplace(key, static_cast<int>(renumber.size())).first;
+                refined[b] = static_cast<uint8_t>(it->second);
+            }
+            std::copy(refined, refined + 256, classOf_);
+            classCount_ = renumber.size();
+        }
+
+        classByte_.assign(classCount_, 0);
+        for (unsigned b = 256; b-- > 0;) {
+            classByte_[classOf_[b]] = static_cast<unsigned char>(b);
+        }
+    }
+
+    // ===== LAZY DFA =====
+
+    void RegexMatcher::addClosure(const Program& program, int state, std::vector<int>& set) {
+        std::vector<int> stack(1, state);
+        while (!stack.empty()) {
+            int s = stack.back();
+            stack.pop_back();
+            if (mark_[s] == generation_) {
+                continue;
+            }
+            mark_[s] = generation_;
+
+            const NFAState& nfaState = program.states[s];
+            if (nfaState.type == STATE_SPLIT) {
+                stack.push_back(nfaState.out1);
+                stack.push_back(nfaState.out);
+            }
+            else {
+                set.push_back(s);
+            }
+        }
+    }
+
+    void RegexMatcher::resetDFA(LazyDFA& dfa, const Program& program, bool unanchored) {
+        dfa.program = &program;
+        dfa.unanchored = unanchored;
+        dfa.next.clear();
+        dfa.sets.clear();
+        dfa.ids.clear();
+
+        generation_++;
+        dfa.startSet.clear();
+        addClosure(program, program.start, dfa.startSet);
+        std::sort(dfa.startSet.begin(), dfa.startSet.end());
+
+        // Nothing consumed yet, so no match; unanchored steps add startSet anyway
+        addState(dfa, unanchored ? std::vector<int>() : dfa.startSet, false);
+    }
+
+    int32_t RegexMatcher::addState(LazyDFA& dfa, const std::vector<int>& set, bool match) {
+        std::string key = stateKey(set, match);
+        auto it = dfa.ids.find(key);
+        if (it != dfa.ids.end()) {
+            return it->second;
+        }
+
+        int32_t handle = static_cast<int32_t>(dfa.next.size() << 1) | (match ? 1 : 0);
+        dfa.ids.emplace(std::move(key), handle);
+        dfa.sets.push_back(set);
+        dfa.next.resize(dfa.next.size() + classCount_, UNKNOWN);
+        statesBuilt_++;
+        return handle;
+    }
+
+    int32_t RegexMatcher::buildTransition(LazyDFA& dfa, int32_t from, unsigned cls) {
+        const Program& program = *dfa.program;
+        const unsigned char byte = classByte_[cls];
+
+        // Step every CHAR state on the class, then close over splits
+        generation_++;
+        std::vector<int> target;
+        auto step = [&](const std::vector<int>& states) {
+            for (int s : states) {
+                const NFAState& nfaState = program.states[s];
+                if (nfaState.type == STATE_CHAR && charSets_[nfaState.set].test(byte)) {
+                    addClosure(program, nfaState.out, target);
+                }
+            }
+        };
+        const size_t row = static_cast<size_t>(from >> 1);
+        step(dfa.sets[row / classCount_]);
+        if (dfa.unanchored) {
+            step(dfa.startSet);
+        }
+
+        if (target.empty() && !dfa.unanchored) {
+            dfa.next[row + cls] = DEAD;
+            return DEAD;
+        }
+
+        std::sort(target.begin(), target.end());
+        bool match = false;
+        for (int s : target) {
+            if (program.states[s].type == STATE_MATCH) {
+                match = true;
+                break;
+            }
+        }
+
+        auto it = dfa.ids.find(stateKey(target, match));
+        if (it == dfa.ids.end() && dfa.sets.size() >= maxCachedStates_) {
+            // Start over with only the start state; from is no longer valid
+            resetDFA(dfa, program, dfa.unanchored);
+            cacheFlushes_++;
+            return addState(dfa, target, match);
+        }
+
+        int32_t to = it != dfa.ids.end() ? it->second : addState(dfa, target, match);
+        dfa.next[row + cls] = to;
+        return to;
+    }
+
+    // ===== SEARCH =====
+
+    void RegexMatcher::markStarts(const char* text, size_t begin, size_t end) {
+        starts_.resize((end - begin + 63) / 64);
+        uint64_t* starts = starts_.data();
+
+        LazyDFA& dfa = reverseDFA_;
+        const int32_t* table = dfa.next.data();
+        int32_t state = 0;
+
+        // Bits are gathered in a register, one word of starts_ at a time
+        for (size_t word = starts_.size(); word-- > 0;) {
+            size_t wordBegin = begin + word * 64;
+            uint64_t bits = 0;
+            for (size_t i = std::min(end, wordBegin + 64); i-- > wordBegin;) {
+                unsigned cls = classOf_[static_cast<unsigned char>(text[i])];
+                int32_t next = table[(state >> 1) + cls];
+                if (next < 0) {
+                    next = buildTransition(dfa, state, cls);   // Unanchored: never DEAD
+                    table = dfa.next.data();
+                }
+                state = next;
+                bits |= uint64_t(state & 1) << (i - wordBegin);
+            }
+            starts[word] = bits;
+        }
+
+        bytesScanned_ += end - begin;
+    }
+
+    size_t RegexMatcher::nextStart(size_t position, size_t begin, size_t end) const {
+        if (position >= end) {
+            return end;
+        }
+
+        size_t word = (position - begin) / 64;
+        uint64_t bits = starts_[word] & (~uint64_t(0) << ((position - begin) % 64));
+        while (bits == 0) {
+            if (++word == starts_.size()) {
+                return end;
+            }
+            bits = starts_[word];
+        }
+
+        // Index of the lowest set bit = popcount of the zeros below it
+        return begin + word * 64 + std::bitset<64>((bits & (~bits + 1)) - 1).count();
+    }
+
+    size_t RegexMatcher::longestMatch(const char* text, size_t end, size_t start) {
+        LazyDFA& dfa = forwardDFA_;
+        const int32_t* table = dfa.next.data();
+        int32_t state = 0;
+        size_t matchEnd = start;
+        size_t i = start;
+
+        while (i < end) {
+            unsigned cls = classOf_[static_cast<unsigned char>(text[i])];
+            int32_t next = table[(state >> 1) + cls];
+            if (next < 0) {
+                if (next == DEAD || (next = buildTransition(dfa, state, cls)) == DEAD) {
+                    break;
+                }
+                table = dfa.next.data();
+            }
+            state = next;
+            i++;
+            if (state & 1) {
+                matchEnd = i;
+            }
+        }
+
+        bytesScanned_ += i - start;
+        return matchEnd;
+    }
+
+    // ===== LITERAL PREFILTER =====
+
+    void RegexMatcher::choosePrefilter(const std::vector<std::string>& cover) {
+        literals_.clear();
+        literalScanner_.reset();
+        literalAutomaton_.reset();
+        shortestLiteral_ = 0;
+
+        if (cover.empty() || maxMatchLength_ == UNBOUNDED) {
+            return;
+        }
+
+        // One literal can be scanned with findLiteral, far faster than a set
+        std::vector<std::string> literals = cover;
+        if (literals.size() > 1) {
+            std::string common = commonSubstring(literals);
+            if (common.length() >= MIN_COMMON_LITERAL) {
+                literals.assign(1, common);
+            }
+        }
+
+        // Windows around frequent literals would cover most of the text
+        if (literalDensity(literals) * 2.0 * static_cast<double>(maxMatchLength_) > MAX_WINDOW_COVERAGE) {
+            return;
+        }
+
+        if (literals.size() > 1) {
+            // AhoCorasick only tells A, C, G, T, U and N apart
+            for (const auto& literal : literals) {
+                for (char c : literal) {
+                    if (AhoCorasick::symbolOf(c) == AhoCorasick::SYMBOL_OTHER) {
+                        return;
+                    }
+                }
+            }
+
+            literalAutomaton_ = std::make_unique<AhoCorasick>();
+            for (const auto& literal : literals) {
+                literalAutomaton_->addPattern(literal, literal);
+            }
+            literalAutomaton_->buildAutomaton();
+            literalScanner_ = std::make_unique<AhoCorasick::Scanner>(*literalAutomaton_);
+        }
+
+        literals_ = literals;
+        shortestLiteral_ = literals_.front().length();
+        for (const auto& literal : literals_) {
+            shortestLiteral_ = std::min(shortestLiteral_, literal.length());
+        }
+    }
+
+    void RegexMatcher::startCandidates() {
+        if (literalScanner_) {
+            literalScanner_->finish();
+        }
+    }
+
+    void RegexMatcher::findCandidates(const char* text, size_t from, size_t to) {
+        candidateEnds_.clear();
+
+        if (literalScanner_) {
+            literalScanner_->feedEach(text + from, to - from, [&](size_t position, int, size_t length, int) {
+                candidateEnds_.push_back(position + length);
+            });
+        }
+        else {
+            // Hits may start up to length - 1 bytes before from
+            const std::string& literal = literals_.front();
+            const size_t length = literal.length();
+            size_t position = from >= length - 1 ? from - (length - 1) : 0;
+
+            while (position + length <= to) {
+                position += CompositionKernel::findLiteral(text + position, to - position,
+                    literal.data(), length);
+                if (position + length > to) {
+                    break;
+                }
+                candidateEnds_.push_back(position + length);
+                position++;
+            }
+        }
+
+        candidates_ += candidateEnds_.size();
+    }
+
+    std::vector<MatchResult> RegexMatcher::search(const std::string& text, const std::string& pattern) {
+        std::vector<MatchResult> results;
+        if (!compile(pattern)) {
+            return results;
+        }
+
+        searchEach(text, [&](size_t position, int, size_t length, int) {
+            results.emplace_back(position, text.substr(position, length), 0, "Regex Match", "Regex");
+        });
+        return results;
+    }
+
+    // ===== DESCRIPTION =====
+
+    std::string RegexMatcher::describeNFA() const {
+        if (!isCompiled()) {
+            return "";
+        }
+
+        std::ostringstream oss;
+        oss << "Thompson NFA for " << pattern_ << "\n";
+        oss << "    States: " << forward_.states.size() << ", start: " << forward_.start
+            << ", byte classes: " << classCount_ << "\n";
+
+        for (size_t i = 0; i < forward_.states.size(); ++i) {
+            const NFAState& s = forward_.states[i];
+            oss << "    " << i << ": ";
+            switch (s.type) {
+            case STATE_CHAR:
+                oss << formatSet(charSets_[s.set]) << " -> " << s.out;
+                break;
+            case STATE_SPLIT:
+                oss << "split -> " << s.out << ", " << s.out1;
+                break;
+            case STATE_MATCH:
+                oss << "MATCH";
+                break;
+            }
+            oss << "\n";
+        }
+
+        return oss.str();
+    }
+
+} // namespace DNACore
\ No newline at end of file
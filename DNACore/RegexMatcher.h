@@ -0,0 +1,320 @@
+#pragma once
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "AnalysisTypes.h"
+#include "AhoCorasick.h"
+
+namespace DNACore {
+
+    /**
+     * Regular expressions over sequences, compiled to a Thompson NFA and
+     * executed as a lazily built DFA
+     *
+     * Syntax: literals, '.', classes ([ACGT], [^N], [A-D]), groups ( ),
+     * alternation |, repeats * + ? {n} {n,} {n,m}, and '\' to take a
+     * metacharacter literally. Matching is byte-wise and case-sensitive.
+     *
+     * Matches are leftmost-longest, non-empty and non-overlapping. A DFA for
+     * the reversed pattern runs once over the text, right to left, and marks
+     * every position where some match starts; an anchored forward DFA then
+     * finds the longest match from each marked start. A DFA state is a set of
+     * NFA states, built the first time a transition needs it and kept in a
+     * table of at most maxCachedStates() states. When the table is full it
+     * is flushed and refilled as the scan continues, so memory stays bounded
+     * for any pattern. Nothing is ever backtracked: every byte read costs
+     * one table lookup, or one NFA step when the transition is new.
+     *
+     * Literal prefilter: compile() looks for a set of literals at least one
+     * of which every match must contain (TATA in TATA[AT]A[AT], GGGCGG in
+     * GGGCGG.{0,40}CCAAT). If the pattern also has a bounded match length
+     * and the literals are rare enough, the text is first scanned for them
+     * (CompositionKernel::findLiteral for one literal, AhoCorasick for
+     * several) and the DFA passes only run over windows of maximum match
+     * length around each hit. Results are identical either way.
+     */
+    class RegexMatcher {
+    public:
+        static constexpr size_t DEFAULT_CACHED_STATES = 4096;
+
+        // Bytes of text scanned for literals per batch of candidates
+        static constexpr size_t CANDIDATE_CHUNK = 1 << 16;
+
+        // Keeps state handles within int32_t for 256 byte classes
+        static constexpr size_t MAX_CACHED_STATES = 1 << 20;
+
+        // Largest count allowed in {n,m}
+        static constexpr int MAX_REPEAT = 1000;
+
+        // Compiled patterns larger than this are rejected
+        static constexpr size_t MAX_NFA_STATES = 1 << 16;
+
+        RegexMatcher();
+        ~RegexMatcher();
+
+        /**
+         * Compile a pattern, replacing the previous one
+         * @return false on a syntax error; see getError()
+         */
+        bool compile(const std::string& pattern);
+
+        bool isCompiled() const { return !forward_.states.empty(); }
+
+        const std::string& getPattern() const { return pattern_; }
+        const std::string& getError() const { return error_; }
+
+        /**
+         * Compile a pattern and collect every match in text
+         */
+        std::vector<MatchResult> search(const std::string& text, const std::string& pattern);
+
+        /**
+         * Allocation-free search with the compiled pattern: calls
+         * sink(position, patternId, length, editDistance) for every match in
+         * ascending order (patternId and editDistance are always 0)
+         * @return Number of matches delivered before the sink stopped
+         */
+        template <typename Sink>
+        size_t searchEach(const char* text, size_t length, Sink&& sink) {
+            bytesScanned_ = 0;
+            candidates_ = 0;
+            if (!isCompiled() || length == 0) {
+                return 0;
+            }
+
+            size_t found = 0;
+            if (!usesPrefilter()) {
+                searchRange(text, 0, length, found, sink);
+                return found;
+            }
+
+            // A match lies within maxMatchLength_ of a literal hit on either
+            // side; overlapping windows are merged and searched as one range
+            const size_t reach = maxMatchLength_;
+            size_t rangeBegin = 0;
+            size_t rangeEnd = 0;
+            startCandidates();
+
+            for (size_t from = 0; from < length; from += CANDIDATE_CHUNK) {
+                findCandidates(text, from, std::min(length, from + CANDIDATE_CHUNK));
+
+                for (size_t literalEnd : candidateEnds_) {
+                    size_t windowBegin = literalEnd > reach ? literalEnd - reach : 0;
+                    size_t windowEnd = std::min(length, literalEnd - shortestLiteral_ + reach);
+                    if (rangeEnd > rangeBegin && windowBegin <= rangeEnd) {
+                        rangeEnd = std::max(rangeEnd, windowEnd);
+                        continue;
+                    }
+                    if (rangeEnd > rangeBegin && !searchRange(text, rangeBegin, rangeEnd, found, sink)) {
+                        return found;
+                    }
+                    rangeBegin = windowBegin;
+                    rangeEnd = windowEnd;
+                }
+            }
+
+            if (rangeEnd > rangeBegin) {
+                searchRange(text, rangeBegin, rangeEnd, found, sink);
+            }
+            return found;
+        }
+
+        template <typename Sink>
+        size_t searchEach(const std::string& text, Sink&& sink) {
+            return searchEach(text.data(), text.length(), sink);
+        }
+
+        /**
+         * One line per NFA state, for display
+         */
+        std::string describeNFA() const;
+
+        /**
+         * Literals the prefilter scans for (empty when it is not used)
+         */
+        const std::vector<std::string>& getLiterals() const { return literals_; }
+
+        bool usesPrefilter() const { return prefilterEnabled_ && !literals_.empty(); }
+
+        /**
+         * Allow or forbid the literal prefilter (allowed by default)
+         */
+        void setPrefilterEnabled(bool enabled) { prefilterEnabled_ = enabled; }
+
+        /**
+         * Longest possible match, or SIZE_MAX if unbounded
+         */
+        size_t getMaxMatchLength() const { return maxMatchLength_; }
+
+        /**
+         * Bound on cached DFA states per direction (4 to MAX_CACHED_STATES)
+         */
+        void setMaxCachedStates(size_t states) {
+            maxCachedStates_ = std::min(std::max(states, size_t(4)), MAX_CACHED_STATES);
+        }
+        size_t maxCachedStates() const { return maxCachedStates_; }
+
+        // ===== STATISTICS =====
+
+        size_t getNFAStateCount() const { return forward_.states.size(); }
+        size_t getByteClassCount() const { return classCount_; }
+
+        /**
+         * DFA states built and cache flushes since compile(), both directions
+         */
+        size_t getDFAStatesBuilt() const { return statesBuilt_; }
+        size_t getCacheFlushes() const { return cacheFlushes_; }
+
+        /**
+         * Bytes read by both DFA passes of the last search
+         */
+        size_t getBytesScanned() const { return bytesScanned_; }
+
+        /**
+         * Literal hits the prefilter found in the last search
+         */
+        size_t getCandidateCount() const { return candidates_; }
+
+    private:
+        enum StateType : uint8_t {
+            STATE_CHAR,       // Consume a byte of charSets_[set], go to out
+            STATE_SPLIT,      // Go to out and out1 without consuming
+            STATE_MATCH
+        };
+
+        struct NFAState {
+            StateType type;
+            int set;
+            int out;
+            int out1;
+        };
+
+        struct Program {
+            std::vector<NFAState> states;
+            int start = 0;
+        };
+
+        /**
+         * Transition cache over one Program. States are named by handles:
+         * (first table index of the state's row << 1) | match flag, so a
+         * step is one load and the flag needs no second lookup. The start
+         * state is handle 0. The match flag means a non-empty match ends at
+         * the byte just consumed. An unanchored DFA adds the NFA start to
+         * every state before stepping, so it never dies.
+         */
+        struct LazyDFA {
+            const Program* program = nullptr;
+            bool unanchored = false;
+            std::vector<int32_t> next;                // Row per state, class per column: target handle
+            std::vector<std::vector<int>> sets;       // Sorted NFA states of each DFA state
+            std::unordered_map<std::string, int32_t> ids;
+            std::vector<int> startSet;                // Closure of the NFA start
+        };
+
+        static constexpr int32_t UNKNOWN = -2;
+        static constexpr int32_t DEAD = -1;
+
+        std::string pattern_;
+        std::string error_;
+        std::vector<std::bitset<256>> charSets_;
+        uint8_t classOf_[256];                        // Byte -> equivalence class
+        std::vector<unsigned char> classByte_;        // A representative byte per class
+        size_t classCount_;
+        Program forward_;
+        Program reverse_;                             // The pattern read right to left
+        LazyDFA forwardDFA_;                          // Anchored
+        LazyDFA reverseDFA_;                          // Unanchored
+        size_t maxCachedStates_;
+        std::vector<uint64_t> starts_;                // Bit per position: a match starts here
+        std::vector<uint32_t> mark_;                  // Closure visit generation per NFA state
+        uint32_t generation_;
+        size_t statesBuilt_;
+        size_t cacheFlushes_;
+        size_t bytesScanned_;
+
+        // Prefilter
+        std::vector<std::string> literals_;
+        size_t shortestLiteral_;
+        size_t maxMatchLength_;
+        bool prefilterEnabled_;
+        std::unique_ptr<AhoCorasick> literalAutomaton_;          // Set when there are several literals
+        std::unique_ptr<AhoCorasick::Scanner> literalScanner_;
+        std::vector<size_t> candidateEnds_;
+        size_t candidates_;
+
+        /**
+         * Search text[begin, end), assuming no match crosses either bound
+         * @return false if the sink stopped the search
+         */
+        template <typename Sink>
+        bool searchRange(const char* text, size_t begin, size_t end, size_t& found, Sink& sink) {
+            markStarts(text, begin, end);
+
+            size_t position = nextStart(begin, begin, end);
+            while (position < end) {
+                size_t matchEnd = longestMatch(text, end, position);
+                found++;
+                if (!detail::emitMatch(sink, position, 0, matchEnd - position, 0)) {
+                    return false;
+                }
+                position = nextStart(matchEnd, begin, end);
+            }
+            return true;
+        }
+
+        /**
+         * Reverse pass over text[begin, end): fill starts_ (bit i - begin)
+         */
+        void markStarts(const char* text, size_t begin, size_t end);
+
+        /**
+         * First marked start at or after position, or end
+         */
+        size_t nextStart(size_t position, size_t begin, size_t end) const;
+
+        /**
+         * Forward pass from a marked start: end of the longest match
+         */
+        size_t longestMatch(const char* text, size_t end, size_t start);
+
+        /**
+         * Pick literals_ from the literal cover of the pattern
+         */
+        void choosePrefilter(const std::vector<std::string>& cover);
+
+        void startCandidates();
+
+        /**
+         * Fill candidateEnds_ with the end of every literal hit ending in
+         * (from, to], ascending; calls must cover the text in order
+         */
+        void findCandidates(const char* text, size_t from, size_t to);
+
+        /**
+         * Fill in a missing transition, flushing the cache if it is full
+         * @return Target handle (old handles are void after a flush), or DEAD
+         */
+        int32_t buildTransition(LazyDFA& dfa, int32_t from, unsigned cls);
+
+        void resetDFA(LazyDFA& dfa, const Program& program, bool unanchored);
+
+        int32_t addState(LazyDFA& dfa, const std::vector<int>& set, bool match);
+
+        /**
+         * Add state and everything reachable from it without consuming a
+         * byte to set (CHAR and MATCH states only)
+         */
+        void addClosure(const Program& program, int state, std::vector<int>& set);
+
+        /**
+         * Partition bytes into classes no character set distinguishes
+         */
+        void buildByteClasses();
+    };
+
+} // namespace DNACore
\ No newline at end of file
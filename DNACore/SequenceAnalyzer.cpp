@@ -1,11 +1,86 @@
 #include "SequenceAnalyzer.h"
+#include "CompositionKernel.h"
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
 
 namespace DNACore {
 
+    namespace {
+
+        SequenceStatistics statisticsFromComposition(const BaseComposition& composition, size_t totalLength) {
+            SequenceStatistics stats;
+            stats.totalLength = totalLength;
+
+            stats.adenineCount = composition.adenine;
+            stats.thymineCount = composition.thymine;
+            stats.guanineCount = composition.guanine;
+            stats.cytosineCount = composition.cytosine;
+            stats.uracilCount = composition.uracil;
+
+            // Calculate percentages
+            if (stats.totalLength > 0) {
+                stats.adeninePercent = (stats.adenineCount * 100.0) / stats.totalLength;
+                stats.thyminePercent = (stats.thymineCount * 100.0) / stats.totalLength;
+                stats.guaninePercent = (stats.guanineCount * 100.0) / stats.totalLength;
+                stats.cytosinePercent = (stats.cytosineCount * 100.0) / stats.totalLength;
+                stats.uracilPercent = (stats.uracilCount * 100.0) / stats.totalLength;
+
+                // GC content from the same pass
+                stats.gcContent = (composition.gcCount() * 100.0) / stats.totalLength;
+            }
+
+            // Determine sequence type
+            if (stats.uracilCount > 0 && stats.thymineCount == 0) {
+                stats.sequenceType = "RNA";
+            }
+            else if (stats.thymineCount > 0 && stats.uracilCount == 0) {
+                stats.sequenceType = "DNA";
+            }
+            else if (stats.uracilCount > 0 && stats.thymineCount > 0) {
+                stats.sequenceType = "Mixed (DNA/RNA)";
+            }
+            else {
+                stats.sequenceType = "Unknown";
+            }
+
+            return stats;
+        }
+
+        /**
+         * Scan text (std::string or PackedSequence) and group hits by motif
+         */
+        template <typename Text>
+        void collectMotifs(const AhoCorasick& automaton, const Text& text, SequenceStatistics& stats) {
+            std::unordered_map<std::string, MotifOccurrence> motifMap;
+
+            automaton.scanEach(text, [&](size_t position, int patternId, size_t, int) {
+                const AhoCorasick::PatternInfo& info = automaton.getPattern(patternId);
+                auto& occurrence = motifMap[info.motifName];
+                if (occurrence.motifName.empty()) {
+                    occurrence.motifName = info.motifName;
+                    occurrence.motifPattern = info.strand == '-'
+                        ? IUPACCode::reverseComplement(info.pattern)
+                        : info.pattern;
+                }
+                occurrence.positions.push_back(position);
+                occurrence.count++;
+            });
+
+            // Convert to vector
+            for (const auto& pair : motifMap) {
+                stats.motifs.push_back(pair.second);
+            }
+        }
+
+    } // namespace
+
     SequenceAnalyzer::SequenceAnalyzer()
         : kmpMatcher_(std::make_unique<KMPMatcher>()),
-          ahoCorasick_(std::make_unique<AhoCorasick>()),
+          myersMatcher_(std::make_unique<MyersMatcher>()),
+          shiftAndMatcher_(std::make_unique<ShiftAndMatcher>()),
           pda_(std::make_unique<PushdownAutomaton>()),
+          regexMatcher_(std::make_unique<RegexMatcher>()) {
     }
 
     SequenceAnalyzer::~SequenceAnalyzer() {
@@ -14,7 +89,13 @@ namespace DNACore {
     // ===== SEQUENCE MANAGEMENT =====
 
     void SequenceAnalyzer::setSequence(const std::string& sequence) {
-        sequence_ = toUpperCase(sequence);
+        // Convert in place so a reused analyzer keeps its buffer capacity
+        sequence_.assign(sequence);
+        std::transform(sequence_.begin(), sequence_.end(), sequence_.begin(),
+            [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+        // The index describes the previous sequence
+        index_.reset();
     }
 
     std::string SequenceAnalyzer::toUpperCase(const std::string& str) const {
@@ -24,7 +105,7 @@ namespace DNACore {
         return result;
     }
 
-    // ===== EXACT MATCHING (KMP) =====
+    // ===== EXACT MATCHING =====
 
     std::vector<MatchResult> SequenceAnalyzer::exactMatch(const std::string& pattern) {
         if (sequence_.empty() || pattern.empty()) {
@@ -32,12 +113,24 @@ namespace DNACore {
         }
 
         std::string upperPattern = toUpperCase(pattern);
+        const char* algorithm = algorithmName(exactAlgorithm(upperPattern));
 
         // Record trace start
-        dfaTracer_.recordStart("KMP", sequence_, upperPattern);
+        dfaTracer_.recordStart(algorithm, sequence_, upperPattern);
 
-        // Perform KMP search
-        auto results = kmpMatcher_->search(sequence_, upperPattern);
+        // Search through the index, KMP or Shift-And
+        std::vector<MatchResult> results;
+        auto collect = [&](size_t position, int, size_t length, int dist) {
+            results.emplace_back(
+                position,
+                sequence_.substr(position, length),
+                dist,  // 0 (exact match)
+                "Exact Match",
+                algorithm
+            );
+        };
+        auto filter = filterFor(collect);
+        size_t work = exactSearchEach(upperPattern, filter);
 
         // Record matches
         for (const auto& result : results) {
@@ -45,7 +138,7 @@ namespace DNACore {
         }
 
         // Record completion
-        dfaTracer_.recordComplete(results.size(), kmpMatcher_->getComparisons());
+        dfaTracer_.recordComplete(results.size(), work);
 
         return results;
     }
@@ -70,7 +163,7 @@ namespace DNACore {
             dfaTracer_.recordMatch(result.position, result.matchedSequence);
         }
 
-        dfaTracer_.recordComplete(results.size());
+        dfaTracer_.recordComplete(results.size(), myersMatcher_->getColumns());
 
         return results;
     }
@@ -78,59 +171,21 @@ namespace DNACore {
     std::vector<MatchResult> SequenceAnalyzer::fuzzySearch(const std::string& pattern, int maxDistance) {
         std::vector<MatchResult> results;
 
-        size_t n = sequence_.length();
-        size_t m = pattern.length();
-
-        // Check all substrings of similar length
-        for (size_t i = 0; i < n; ++i) {
-            // Try different lengths around pattern length
-            for (size_t len = (m > maxDistance ? m - maxDistance : 1);
-                len <= m + maxDistance && i + len <= n;
-                ++len) {
-
-                std::string substring = sequence_.substr(i, len);
-                int dist = editDistance(substring, pattern);
-
-                if (dist <= maxDistance) {
-                    results.emplace_back(
-                        i,
-                        substring,
-                        dist,
-                        "Approx Match (dist=" + std::to_string(dist) + ")",
-                        "Levenshtein"
-                    );
-                }
-            }
-        }
+        auto collect = [&](size_t position, int, size_t length, int dist) {
+            results.emplace_back(
+                position,
+                sequence_.substr(position, length),
+                dist,
+                "Approx Match (dist=" + std::to_string(dist) + ")",
+                "Levenshtein"
+            );
+        };
+        auto filter = filterFor(collect);
+        fuzzySearchEach(pattern, maxDistance, filter);
 
         return results;
     }
 
-    int SequenceAnalyzer::editDistance(const std::string& s1, const std::string& s2) {
-        size_t m = s1.length();
-        size_t n = s2.length();
-
-        std::vector<std::vector<int>> dp(m + 1, std::vector<int>(n + 1));
-
-        // Initialize base cases
-        for (size_t i = 0; i <= m; ++i) dp[i][0] = static_cast<int>(i);
-        for (size_t j = 0; j <= n; ++j) dp[0][j] = static_cast<int>(j);
-
-        // Fill DP table
-        for (size_t i = 1; i <= m; ++i) {
-            for (size_t j = 1; j <= n; ++j) {
-                if (s1[i - 1] == s2[j - 1]) {
-                    dp[i][j] = dp[i - 1][j - 1];
-                }
-                else {
-                    dp[i][j] = 1 + std::min({ dp[i - 1][j], dp[i][j - 1], dp[i - 1][j - 1] });
-                }
-            }
-        }
-
-        return dp[m][n];
-    }
-
     // ===== MOTIF SEARCH (AHO-CORASICK) =====
 
     std::vector<MatchResult> SequenceAnalyzer::searchMotif(int motifType) {
@@ -138,9 +193,6 @@ namespace DNACore {
             return {};
         }
 
-        // Clear previous patterns
-        ahoCorasick_->clear();
-
         // Get motif
         auto motif = MotifDatabase::getMotif(static_cast<MotifDatabase::MotifType>(motifType));
 
@@ -148,22 +200,28 @@ namespace DNACore {
             return {};
         }
 
-        // Add pattern to Aho-Corasick
-        ahoCorasick_->addPattern(motif.pattern, motif.name);
-        ahoCorasick_->buildAutomaton();
+        // Reuse the compiled automaton for this motif
+        auto automaton = MotifAutomatonCache::getMotif(motif.type, options_.bothStrands);
 
         // Record trace
         dfaTracer_.recordStart("Aho-Corasick", sequence_, motif.pattern);
 
         // Search
-        auto results = ahoCorasick_->search(sequence_);
+        std::vector<MatchResult> results;
+        auto collect = [&](size_t position, int patternId, size_t, int dist) {
+            const auto& info = automaton->getPattern(patternId);
+            results.emplace_back(position, info.pattern, dist, info.motifName, "Aho-Corasick", info.strand);
+        };
+        auto filter = filterFor(collect);
+        automaton->scanEach(sequence_, filter);
 
         // Record matches
         for (const auto& result : results) {
             dfaTracer_.recordMatch(result.position, result.matchedSequence);
         }
 
-        dfaTracer_.recordComplete(results.size(), ahoCorasick_->getStateTransitions());
+        // One goto-table transition per base
+        dfaTracer_.recordComplete(results.size(), sequence_.length());
 
         return results;
     }
@@ -173,32 +231,210 @@ namespace DNACore {
             return {};
         }
 
-        // Clear and build automaton with all motifs
-        ahoCorasick_->clear();
-
-        auto allMotifs = MotifDatabase::getAllMotifs();
-        
-        // Add each motif pattern
-        for (const auto& motif : allMotifs) {
-            if (!motif.pattern.empty()) {
-                ahoCorasick_->addPattern(motif.pattern, motif.name);
-            }
-        }
-
-        ahoCorasick_->buildAutomaton();
+        // Reuse the compiled automaton with all motifs
+        auto automaton = MotifAutomatonCache::getAllMotifs(options_.bothStrands);
 
         // Record trace
         dfaTracer_.recordStart("Aho-Corasick (Multi-Pattern)", sequence_, "Multiple Motifs");
 
         // Search
-        auto results = ahoCorasick_->search(sequence_);
+        std::vector<MatchResult> results;
+        auto collect = [&](size_t position, int patternId, size_t, int dist) {
+            const auto& info = automaton->getPattern(patternId);
+            results.emplace_back(position, info.pattern, dist, info.motifName, "Aho-Corasick", info.strand);
+        };
+        auto filter = filterFor(collect);
+        automaton->scanEach(sequence_, filter);
 
         // Record matches
         for (const auto& result : results) {
             dfaTracer_.recordMatch(result.position, result.matchedSequence);
         }
 
-        dfaTracer_.recordComplete(results.size(), ahoCorasick_->getStateTransitions());
+        // One goto-table transition per base
+        dfaTracer_.recordComplete(results.size(), sequence_.length());
+
+        return results;
+    }
+
+    // ===== COUNT / EXISTENCE SEARCH =====
+
+    MotifAutomatonCache::AutomatonPtr SequenceAnalyzer::motifAutomaton(int motifType) const {
+        if (motifType == 0) {
+            return MotifAutomatonCache::getAllMotifs(options_.bothStrands);
+        }
+        return MotifAutomatonCache::getMotif(static_cast<MotifDatabase::MotifType>(motifType),
+            options_.bothStrands);
+    }
+
+    size_t SequenceAnalyzer::countExactMatches(const std::string& pattern) {
+        if (sequence_.empty() || pattern.empty()) {
+            return 0;
+        }
+
+        std::string upperPattern = toUpperCase(pattern);
+
+        // Overlapping, unlimited counts come straight from the index
+        if (options_.findOverlapping && options_.maxResults == 0 &&
+            !IUPACCode::isDegenerate(upperPattern) && ensureIndex()) {
+            return index_->count(upperPattern);
+        }
+
+        auto ignore = [](size_t, int, size_t, int) {};
+        auto filter = filterFor(ignore);
+        exactSearchEach(upperPattern, filter);
+        return filter.accepted();
+    }
+
+    size_t SequenceAnalyzer::countApproximateMatches(const std::string& pattern, int maxDistance) {
+        if (sequence_.empty() || pattern.empty()) {
+            return 0;
+        }
+
+        auto ignore = [](size_t, int, size_t, int) {};
+        auto filter = filterFor(ignore);
+        fuzzySearchEach(toUpperCase(pattern), maxDistance, filter);
+        return filter.accepted();
+    }
+
+    size_t SequenceAnalyzer::countMotifs(int motifType) {
+        if (sequence_.empty()) {
+            return 0;
+        }
+
+        auto automaton = motifAutomaton(motifType);
+        if (!automaton) {
+            return 0;
+        }
+
+        auto ignore = [](size_t, int, size_t, int) {};
+        auto filter = filterFor(ignore);
+        automaton->scanEach(sequence_, filter);
+        return filter.accepted();
+    }
+
+    bool SequenceAnalyzer::hasExactMatch(const std::string& pattern) {
+        if (sequence_.empty() || pattern.empty()) {
+            return false;
+        }
+
+        std::string upperPattern = toUpperCase(pattern);
+        if (!IUPACCode::isDegenerate(upperPattern) && ensureIndex()) {
+            return index_->count(upperPattern) > 0;
+        }
+
+        auto ignore = [](size_t, int, size_t, int) {};
+        auto filter = filterFor(ignore, 1);
+        exactSearchEach(upperPattern, filter);
+        return filter.accepted() > 0;
+    }
+
+    bool SequenceAnalyzer::hasApproximateMatch(const std::string& pattern, int maxDistance) {
+        if (sequence_.empty() || pattern.empty()) {
+            return false;
+        }
+
+        auto ignore = [](size_t, int, size_t, int) {};
+        auto filter = filterFor(ignore, 1);
+        fuzzySearchEach(toUpperCase(pattern), maxDistance, filter);
+        return filter.accepted() > 0;
+    }
+
+    bool SequenceAnalyzer::hasMotif(int motifType) {
+        if (sequence_.empty()) {
+            return false;
+        }
+
+        auto automaton = motifAutomaton(motifType);
+        if (!automaton) {
+            return false;
+        }
+
+        auto ignore = [](size_t, int, size_t, int) {};
+        auto filter = filterFor(ignore, 1);
+        automaton->scanEach(sequence_, filter);
+        return filter.accepted() > 0;
+    }
+
+    // ===== COMPACT SEARCH =====
+
+    CompactMatchResults SequenceAnalyzer::exactMatchCompact(const std::string& pattern) {
+        CompactMatchResults results;
+
+        // Hits are as long as the pattern
+        if (sequence_.empty() || pattern.empty() || pattern.length() > MatchHit::MAX_LENGTH) {
+            return results;
+        }
+
+        std::string upperPattern = toUpperCase(pattern);
+        results.motifTypes.push_back("Exact Match");
+
+        MatchAlgorithm algorithm = exactAlgorithm(upperPattern);
+        dfaTracer_.recordStart(algorithmName(algorithm), sequence_, upperPattern);
+
+        auto collect = [&](size_t position, int patternId, size_t length, int dist) {
+            results.hits.emplace_back(position, patternId, length, dist, algorithm);
+        };
+        auto filter = filterFor(collect);
+        size_t work = exactSearchEach(upperPattern, filter);
+
+        dfaTracer_.recordComplete(results.size(), work);
+
+        return results;
+    }
+
+    CompactMatchResults SequenceAnalyzer::approximateMatchCompact(const std::string& pattern, int maxDistance) {
+        CompactMatchResults results;
+
+        // Hits span at most pattern length + maxDistance bases
+        if (sequence_.empty() || pattern.empty() || maxDistance > MatchHit::MAX_EDIT_DISTANCE ||
+            pattern.length() + static_cast<size_t>(std::max(maxDistance, 0)) > MatchHit::MAX_LENGTH) {
+            return results;
+        }
+
+        std::string upperPattern = toUpperCase(pattern);
+        results.motifTypes.push_back("Approx Match");
+
+        dfaTracer_.recordStart("Levenshtein", sequence_, upperPattern);
+
+        auto collect = [&](size_t position, int patternId, size_t length, int dist) {
+            results.hits.emplace_back(position, patternId, length, dist, MatchAlgorithm::LEVENSHTEIN);
+        };
+        auto filter = filterFor(collect);
+        fuzzySearchEach(upperPattern, maxDistance, filter);
+
+        dfaTracer_.recordComplete(results.size(), myersMatcher_->getColumns());
+
+        return results;
+    }
+
+    CompactMatchResults SequenceAnalyzer::searchAllMotifsCompact() {
+        CompactMatchResults results;
+
+        if (sequence_.empty()) {
+            return results;
+        }
+
+        auto automaton = MotifAutomatonCache::getAllMotifs(options_.bothStrands);
+
+        // Side tables: pattern ids map straight to motif names and strands
+        results.motifTypes.reserve(automaton->getPatternCount());
+        results.strands.reserve(automaton->getPatternCount());
+        for (size_t id = 0; id < automaton->getPatternCount(); ++id) {
+            const auto& info = automaton->getPattern(static_cast<int>(id));
+            results.motifTypes.push_back(info.motifName);
+            results.strands.push_back(info.strand);
+        }
+
+        dfaTracer_.recordStart("Aho-Corasick (Multi-Pattern)", sequence_, "Multiple Motifs");
+
+        auto collect = [&](size_t position, int patternId, size_t length, int dist) {
+            results.hits.emplace_back(position, patternId, length, dist, MatchAlgorithm::AHO_CORASICK);
+        };
+        auto filter = filterFor(collect);
+        automaton->scanEach(sequence_, filter);
+
+        dfaTracer_.recordComplete(results.size(), sequence_.length());
 
         return results;
     }
@@ -217,99 +453,203 @@ namespace DNACore {
         return pda_->search(sequence_, upperPattern);
     }
 
-    // ===== STATISTICS =====
+    // ===== REGEX SEARCH =====
+
+    std::vector<MatchResult> SequenceAnalyzer::regexSearch(const std::string& pattern) {
+        regexError_.clear();
+        regexTrace_.clear();
+
+        // sequence_ is uppercase, so the pattern is too
+        std::string upperPattern = toUpperCase(pattern);
+        if (!regexMatcher_->isCompiled() || regexMatcher_->getPattern() != upperPattern) {
+            if (!regexMatcher_->compile(upperPattern)) {
+                regexError_ = regexMatcher_->getError();
+                return {};
+            }
+        }
 
-    double SequenceAnalyzer::calculateGCContent() const {
         if (sequence_.empty()) {
-            return 0.0;
+            return {};
         }
 
-        size_t gcCount = 0;
-        for (char c : sequence_) {
-            if (c == 'G' || c == 'C') {
-                gcCount++;
+        dfaTracer_.recordStart("Regex", sequence_, upperPattern);
+
+        size_t statesBefore = regexMatcher_->getDFAStatesBuilt();
+        size_t flushesBefore = regexMatcher_->getCacheFlushes();
+
+        std::vector<MatchResult> results;
+        auto collect = [&](size_t position, int, size_t length, int) {
+            results.emplace_back(
+                position,
+                sequence_.substr(position, length),
+                0,
+                "Regex Match",
+                "Regex"
+            );
+        };
+        auto filter = filterFor(collect);
+        regexMatcher_->searchEach(sequence_, filter);
+
+        for (const auto& result : results) {
+            dfaTracer_.recordMatch(result.position, result.matchedSequence);
+        }
+        dfaTracer_.recordComplete(results.size(), regexMatcher_->getBytesScanned());
+
+        std::ostringstream oss;
+        oss << "=== REGEX SEARCH ===\n";
+        oss << "    Pattern: " << upperPattern << "\n";
+        oss << "    Sequence Length: " << sequence_.length() << "\n";
+        oss << "    NFA States: " << regexMatcher_->getNFAStateCount()
+            << ", Byte Classes: " << regexMatcher_->getByteClassCount() << "\n";
+        oss << "    DFA States Built: " << regexMatcher_->getDFAStatesBuilt() - statesBefore
+            << " (cache limit " << regexMatcher_->maxCachedStates() << " per direction)\n";
+        oss << "    Cache Flushes: " << regexMatcher_->getCacheFlushes() - flushesBefore << "\n";
+        if (regexMatcher_->usesPrefilter()) {
+            oss << "    Literal Prefilter:";
+            for (const auto& literal : regexMatcher_->getLiterals()) {
+                oss << " " << literal;
             }
+            oss << " (" << regexMatcher_->getCandidateCount() << " candidates)\n";
         }
+        else {
+            oss << "    Literal Prefilter: none\n";
+        }
+        oss << "    Bytes Scanned: " << regexMatcher_->getBytesScanned() << "\n";
+        oss << "    Total Matches: " << results.size() << "\n";
+        oss << "    Complexity: O(n) per DFA pass, no backtracking\n";
+        regexTrace_ = oss.str();
 
-        return (gcCount * 100.0) / sequence_.length();
+        return results;
     }
 
-    SequenceStatistics SequenceAnalyzer::getStatistics() const {
-        SequenceStatistics stats;
+    std::string SequenceAnalyzer::getNFADescription() const {
+        return regexMatcher_->describeNFA();
+    }
 
-        stats.totalLength = sequence_.length();
+    std::string SequenceAnalyzer::getRegexTrace() const {
+        return regexTrace_;
+    }
 
-        if (sequence_.empty()) {
-            return stats;
-        }
+    std::string SequenceAnalyzer::getRegexError() const {
+        return regexError_;
+    }
 
-        // Count nucleotides
-        for (char c : sequence_) {
-            switch (c) {
-            case 'A': stats.adenineCount++; break;
-            case 'T': stats.thymineCount++; break;
-            case 'G': stats.guanineCount++; break;
-            case 'C': stats.cytosineCount++; break;
-            case 'U': stats.uracilCount++; break;
-            }
-        }
+    // ===== PWM SEARCH =====
 
-        // Calculate percentages
-        if (stats.totalLength > 0) {
-            stats.adeninePercent = (stats.adenineCount * 100.0) / stats.totalLength;
-            stats.thyminePercent = (stats.thymineCount * 100.0) / stats.totalLength;
-            stats.guaninePercent = (stats.guanineCount * 100.0) / stats.totalLength;
-            stats.cytosinePercent = (stats.cytosineCount * 100.0) / stats.totalLength;
-            stats.uracilPercent = (stats.uracilCount * 100.0) / stats.totalLength;
+    std::vector<MatchResult> SequenceAnalyzer::pwmSearch(PWMScanner& scanner) {
+        if (sequence_.empty() || scanner.getMatrixCount() == 0) {
+            return {};
         }
 
-        // GC content
-        stats.gcContent = calculateGCContent();
+        dfaTracer_.recordStart("PWM", sequence_,
+            std::to_string(scanner.getMatrixCount()) + " Matrices");
+
+        // The filter sees positions only; the hit it is judging is kept here
+        const PWMHit* current = nullptr;
 
-        // Determine sequence type
-        if (stats.uracilCount > 0 && stats.thymineCount == 0) {
-            stats.sequenceType = "RNA";
+        std::vector<MatchResult> results;
+        auto collect = [&](size_t position, int matrixId, size_t length, int) {
+            std::ostringstream name;
+            name << scanner.getMatrix(matrixId).getName()
+                << " (score=" << std::fixed << std::setprecision(2) << current->score
+                << ", p=" << std::scientific << std::setprecision(1) << current->pValue << ")";
+            results.emplace_back(position, sequence_.substr(position, length), 0, name.str(), "PWM",
+                current->strand);
+        };
+        auto filter = filterFor(collect);
+        scanner.scanEach(sequence_, [&](const PWMHit& hit) {
+            current = &hit;
+            return filter(hit.position, hit.matrixId, hit.length, 0);
+        });
+
+        for (const auto& result : results) {
+            dfaTracer_.recordMatch(result.position, result.matchedSequence);
         }
-        else if (stats.thymineCount > 0 && stats.uracilCount == 0) {
-            stats.sequenceType = "DNA";
+
+        // Matrix columns added up by the scanner
+        dfaTracer_.recordComplete(results.size(), scanner.getColumnsScored());
+
+        return results;
+    }
+
+    // ===== STATISTICS =====
+
+    double SequenceAnalyzer::calculateGCContent() const {
+        if (sequence_.empty()) {
+            return 0.0;
         }
-        else if (stats.uracilCount > 0 && stats.thymineCount > 0) {
-            stats.sequenceType = "Mixed (DNA/RNA)";
+
+        size_t gcCount = CompositionKernel::count(sequence_).gcCount();
+        return (gcCount * 100.0) / sequence_.length();
+    }
+
+    SequenceStatistics SequenceAnalyzer::getStatistics() const {
+        if (sequence_.empty()) {
+            return SequenceStatistics();
         }
-        else {
-            stats.sequenceType = "Unknown";
+
+        // Count nucleotides in one vectorized pass
+        SequenceStatistics stats = statisticsFromComposition(CompositionKernel::count(sequence_),
+            sequence_.length());
+
+        // Find motifs using the cached Aho-Corasick automaton
+        collectMotifs(*MotifAutomatonCache::getAllMotifs(options_.bothStrands), sequence_, stats);
+
+        return stats;
+    }
+
+    SequenceStatistics SequenceAnalyzer::getStatistics(const PackedSequence& sequence) {
+        if (sequence.empty()) {
+            return SequenceStatistics();
         }
 
-        // Find motifs using Aho-Corasick
-        auto tempAC = std::make_unique<AhoCorasick>();
-        auto allMotifs = MotifDatabase::getAllMotifs();
+        SequenceStatistics stats = statisticsFromComposition(sequence.composition(), sequence.size());
+        collectMotifs(*MotifAutomatonCache::getAllMotifs(), sequence, stats);
 
-        for (const auto& motif : allMotifs) {
-            tempAC->addPattern(motif.pattern, motif.name);
+        return stats;
+    }
+
+    // ===== INDEX =====
+
+    bool SequenceAnalyzer::buildIndex(uint32_t sampleRate) {
+        if (!index_) {
+            index_ = std::make_unique<FMIndex>();
         }
+        return index_->build(sequence_, sampleRate) && !index_->empty();
+    }
 
-        tempAC->buildAutomaton();
-        auto motifResults = tempAC->search(sequence_);
+    bool SequenceAnalyzer::ensureIndex() {
+        if (!options_.useIndex || sequence_.empty()) {
+            return false;
+        }
+        if (!index_) {
+            buildIndex();
+        }
+        return hasIndex();
+    }
 
-        // Group by motif type
-        std::unordered_map<std::string, MotifOccurrence> motifMap;
+    bool SequenceAnalyzer::saveIndex(const std::string& path) {
+        if (!hasIndex() && !buildIndex()) {
+            return false;
+        }
+        return index_->save(path);
+    }
 
-        for (const auto& result : motifResults) {
-            auto& occurrence = motifMap[result.motifType];
-            if (occurrence.motifName.empty()) {
-                occurrence.motifName = result.motifType;
-                occurrence.motifPattern = result.matchedSequence;
-            }
-            occurrence.positions.push_back(result.position);
-            occurrence.count++;
+    bool SequenceAnalyzer::loadIndex(const std::string& path, std::string& error) {
+        auto loaded = std::make_unique<FMIndex>();
+        if (!loaded->load(path)) {
+            error = loaded->getErrors().empty() ? "Cannot load index: " + path : loaded->getErrors().front();
+            return false;
         }
 
-        // Convert to vector
-        for (const auto& pair : motifMap) {
-            stats.motifs.push_back(pair.second);
+        if (loaded->textLength() != sequence_.length() ||
+            loaded->checksum() != FMIndex::checksumOf(sequence_.data(), sequence_.length())) {
+            error = "Index does not match the current sequence: " + path;
+            return false;
         }
 
-        return stats;
+        index_ = std::move(loaded);
+        return true;
     }
 
 } // namespace DNACore
\ No newline at end of file
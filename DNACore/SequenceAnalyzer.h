@@ -8,10 +8,17 @@
 #include "AnalysisTypes.h"
 #include "MotifDatabase.h"
 #include "KMPMatcher.h"
+#include "MyersMatcher.h"
+#include "ShiftAndMatcher.h"
 #include "AhoCorasick.h"
+#include "MotifAutomatonCache.h"
 #include "PushdownAutomaton.h"
 #include "PDALogger.h"
 #include "DFATracer.h"
+#include "WindowProfiler.h"
+#include "FMIndex.h"
+#include "RegexMatcher.h"
+#include "PWMScanner.h"
 
 namespace DNACore {
 
@@ -35,20 +42,37 @@ namespace DNACore {
          */
         const std::string& getSequence() const { return sequence_; }
 
+        /**
+         * Search options: maxResults stops exact, approximate and motif
+         * searches after N hits (0 = unlimited); findOverlapping = false
+         * keeps only hits that start after the previous accepted hit ends
+         */
+        void setOptions(const AnalysisOptions& options) { options_ = options; }
+        const AnalysisOptions& getOptions() const { return options_; }
+
         // ===== SEARCH METHODS =====
 
         /**
-         * Exact pattern matching using KMP algorithm
+         * Exact pattern matching: KMP, or the FM-index while
+         * options.useIndex is set; patterns with IUPAC degenerate codes
+         * (TATAWAWR) run through Shift-And. Results name the algorithm used.
          */
         std::vector<MatchResult> exactMatch(const std::string& pattern);
 
         /**
          * Approximate matching using edit distance
+         * Reports one hit per end position whose minimal distance is
+         * within maxDistance (Myers bit-vector algorithm)
          */
         std::vector<MatchResult> approximateMatch(const std::string& pattern, int maxDistance);
 
         /**
          * Search for known motifs using Aho-Corasick
+         * Compiled automata come from MotifAutomatonCache and are shared
+         * across calls and analyzer instances. With options.bothStrands
+         * (the default) the automaton also holds each motif's reverse
+         * complement, so minus-strand sites are found in the same pass and
+         * reported with strand '-' at their forward position.
          */
         std::vector<MatchResult> searchMotif(int motifType);
 
@@ -62,12 +86,51 @@ namespace DNACore {
          */
         std::vector<MatchResult> pushdownSearch(const std::string& pattern);
 
-        // ===== NEW:  REGEX SEARCH ===== (ADD THIS SECTION)
+        // ===== COUNT / EXISTENCE SEARCH =====
+
+        /**
+         * Count hits without materializing results
+         * Honors findOverlapping; maxResults caps the count and stops early
+         * @param motifType MotifDatabase type (1-5), or 0 for all motifs
+         */
+        size_t countExactMatches(const std::string& pattern);
+        size_t countApproximateMatches(const std::string& pattern, int maxDistance);
+        size_t countMotifs(int motifType = 0);
+
+        /**
+         * Presence checks that stop at the first hit
+         */
+        bool hasExactMatch(const std::string& pattern);
+        bool hasApproximateMatch(const std::string& pattern, int maxDistance);
+        bool hasMotif(int motifType = 0);
+
+        // ===== COMPACT SEARCH =====
+
+        /**
+         * Compact counterparts of exactMatch, approximateMatch and
+         * searchAllMotifs. Hits are 16-byte MatchHit records with motif names
+         * in a side table; CompactMatchResults::materialize() together with
+         * getSequence() recovers full MatchResult objects on demand.
+         * The DFA tracer records the summary only, not every match.
+         * Patterns longer than MatchHit::MAX_LENGTH bases (counting
+         * maxDistance for approximate searches), or a maxDistance above
+         * MatchHit::MAX_EDIT_DISTANCE, do not fit the records and return
+         * no hits; use exactMatch / approximateMatch for those.
+         */
+        CompactMatchResults exactMatchCompact(const std::string& pattern);
+        CompactMatchResults approximateMatchCompact(const std::string& pattern, int maxDistance);
+        CompactMatchResults searchAllMotifsCompact();
+
+        // ===== REGEX SEARCH =====
 
         /**
          * Search using regex pattern (compiled to NFA)
+         * Leftmost-longest, non-overlapping matches found by a lazily built
+         * DFA (see RegexMatcher); the last compiled pattern and its DFA
+         * cache are kept for the next call. maxResults applies.
          * @param pattern Regex pattern (e.g., "A(T|G)*C")
-         * @return Vector of matches
+         * @return Vector of matches; empty with getRegexError() set if the
+         *         pattern does not compile
          */
         std::vector<MatchResult> regexSearch(const std::string& pattern);
 
@@ -86,6 +149,17 @@ namespace DNACore {
          */
         std::string getRegexError() const;
 
+        // ===== PWM SEARCH =====
+
+        /**
+         * Score the sequence against every matrix of a scanner (see
+         * PWMScanner); thresholds and strands follow the scanner's Config.
+         * motifType holds the matrix name with the window's score in bits
+         * and its p-value; matchedSequence is the forward-strand window.
+         * findOverlapping and maxResults apply.
+         */
+        std::vector<MatchResult> pwmSearch(PWMScanner& scanner);
+
         // ===== STATISTICS =====
 
         /**
@@ -93,11 +167,53 @@ namespace DNACore {
          */
         SequenceStatistics getStatistics() const;
 
+        /**
+         * Statistics of a 2-bit packed sequence, without unpacking it
+         * (counts from popcounts, motifs on both strands from a block-wise
+         * scan)
+         */
+        static SequenceStatistics getStatistics(const PackedSequence& sequence);
+
         /**
          * Calculate GC content percentage
          */
         double calculateGCContent() const;
 
+        /**
+         * GC content, GC skew and AT skew over sliding windows
+         * @param windowSize Bases per window
+         * @param step Distance between window starts
+         */
+        WindowProfile getWindowProfile(size_t windowSize, size_t step = 1) const {
+            return WindowProfiler::profile(sequence_, windowSize, step);
+        }
+
+        // ===== INDEX =====
+
+        /**
+         * Build the FM-index of the current sequence now rather than on the
+         * first exact query; queries use it while options.useIndex is set.
+         * setSequence() drops it.
+         * @return false if the sequence cannot be indexed
+         */
+        bool buildIndex(uint32_t sampleRate = FMIndex::DEFAULT_SAMPLE_RATE);
+
+        bool hasIndex() const { return index_ && !index_->empty(); }
+
+        const FMIndex* getIndex() const { return index_.get(); }
+
+        /**
+         * Write the index to disk, building it first if needed
+         */
+        bool saveIndex(const std::string& path);
+
+        /**
+         * Attach a saved index; it must have been built from the current
+         * sequence (same length and checksum)
+         * @param error Receives a message on failure
+         */
+        bool loadIndex(const std::string& path, std::string& error);
+
         // ===== TRACERS =====
 
         DFATracer* getDFATracer() { return &dfaTracer_; }
@@ -106,19 +222,141 @@ namespace DNACore {
 
     private:
         std::string sequence_;
+        AnalysisOptions options_;
 
         // Algorithm instances
         std::unique_ptr<KMPMatcher> kmpMatcher_;
-        std::unique_ptr<AhoCorasick> ahoCorasick_;
+        std::unique_ptr<MyersMatcher> myersMatcher_;
+        std::unique_ptr<ShiftAndMatcher> shiftAndMatcher_;
         std::unique_ptr<PushdownAutomaton> pda_;
+        std::unique_ptr<FMIndex> index_;         // Exact-match index of sequence_, if built
+        std::unique_ptr<RegexMatcher> regexMatcher_;
+
+        // Regex state of the last regexSearch
+        std::string regexError_;
+        std::string regexTrace_;
 
         // Tracers
         DFATracer dfaTracer_;
         PDALogger pdaLogger_;
 
+        /**
+         * Sink adapter applying AnalysisOptions: drops overlapping hits when
+         * findOverlapping is off and stops the search after maxResults hits
+         */
+        template <typename Sink>
+        class OptionsFilter {
+        public:
+            OptionsFilter(const AnalysisOptions& options, Sink& sink, size_t limit)
+                : sink_(sink), overlapping_(options.findOverlapping),
+                limit_(limit), nextStart_(0), accepted_(0) {
+            }
+
+            bool operator()(size_t position, int patternId, size_t length, int editDistance) {
+                if (!overlapping_) {
+                    if (position < nextStart_) {
+                        return true;
+                    }
+                    nextStart_ = position + length;
+                }
+
+                accepted_++;
+                bool keepGoing = detail::emitMatch(sink_, position, patternId, length, editDistance);
+                return keepGoing && (limit_ == 0 || accepted_ < limit_);
+            }
+
+            size_t accepted() const { return accepted_; }
+
+        private:
+            Sink& sink_;
+            bool overlapping_;
+            size_t limit_;
+            size_t nextStart_;
+            size_t accepted_;
+        };
+
+        template <typename Sink>
+        OptionsFilter<Sink> filterFor(Sink& sink, size_t limit) const {
+            return OptionsFilter<Sink>(options_, sink, limit);
+        }
+
+        template <typename Sink>
+        OptionsFilter<Sink> filterFor(Sink& sink) const {
+            return OptionsFilter<Sink>(options_, sink, options_.maxResults);
+        }
+
+        /**
+         * Automaton for a MotifDatabase type, or all motifs for 0
+         */
+        MotifAutomatonCache::AutomatonPtr motifAutomaton(int motifType) const;
+
         // Helper methods
         std::vector<MatchResult> fuzzySearch(const std::string& pattern, int maxDistance);
-        int editDistance(const std::string& s1, const std::string& s2);
+
+        /**
+         * Build the index if options_.useIndex asks for it
+         * @return true if exact queries can use index_
+         */
+        bool ensureIndex();
+
+        /**
+         * Exact search through the FM-index (options_.useIndex) or KMP;
+         * degenerate patterns always scan the sequence (see classSearchEach).
+         * Hits arrive in ascending position order either way
+         * @return Work done, for the trace: KMP comparisons, or backward
+         *         search steps plus located hits
+         */
+        template <typename Sink>
+        size_t exactSearchEach(const std::string& pattern, Sink&& sink) {
+            if (IUPACCode::isDegenerate(pattern)) {
+                return classSearchEach(pattern, sink);
+            }
+
+            if (!ensureIndex()) {
+                kmpMatcher_->searchEach(sequence_, pattern, sink);
+                return kmpMatcher_->getComparisons();
+            }
+
+            std::vector<size_t> positions = index_->locate(pattern);
+            for (size_t position : positions) {
+                if (!detail::emitMatch(sink, position, 0, pattern.length(), 0)) {
+                    break;
+                }
+            }
+            return pattern.length() + positions.size();
+        }
+
+        /**
+         * Single pass for a degenerate pattern with Shift-And (one state
+         * word per 64 bases)
+         * @return Bases read
+         */
+        template <typename Sink>
+        size_t classSearchEach(const std::string& pattern, Sink&& sink) {
+            shiftAndMatcher_->searchEach(sequence_, pattern, sink);
+            return shiftAndMatcher_->getCharactersRead();
+        }
+
+        /**
+         * Algorithm exactSearchEach() will use for a pattern (builds the
+         * index if options_.useIndex asks for it)
+         */
+        MatchAlgorithm exactAlgorithm(const std::string& pattern) {
+            if (IUPACCode::isDegenerate(pattern)) {
+                return MatchAlgorithm::SHIFT_AND;
+            }
+            return ensureIndex() ? MatchAlgorithm::FM_INDEX : MatchAlgorithm::KMP;
+        }
+
+        /**
+         * Allocation-free approximate search (Myers bit-vector): calls
+         * sink(position, patternId, length, editDistance) once per end
+         * position within maxDistance
+         */
+        template <typename Sink>
+        void fuzzySearchEach(const std::string& pattern, int maxDistance, Sink&& sink) {
+            myersMatcher_->searchEach(sequence_, pattern, maxDistance, sink);
+        }
         std::string toUpperCase(const std::string& str) const;
     };
 
@@ -0,0 +1,46 @@
+#include "ShiftAndMatcher.h"
+
+namespace DNACore {
+
+    ShiftAndMatcher::ShiftAndMatcher()
+        : words_(0), charactersRead_(0) {
+    }
+
+    ShiftAndMatcher::~ShiftAndMatcher() {
+    }
+
+    void ShiftAndMatcher::preparePattern(const std::string& pattern) {
+        if (pattern == pattern_) {
+            return;
+        }
+        pattern_ = pattern;
+        words_ = (pattern.length() + WORD_BITS - 1) / WORD_BITS;
+        masks_.assign(256 * words_, 0);
+
+        for (int byte = 0; byte < 256; ++byte) {
+            uint64_t* mask = &masks_[byte * words_];
+            for (size_t i = 0; i < pattern.length(); ++i) {
+                if (IUPACCode::matches(pattern[i], static_cast<char>(byte))) {
+                    mask[i / WORD_BITS] |= uint64_t(1) << (i % WORD_BITS);
+                }
+            }
+        }
+    }
+
+    std::vector<MatchResult> ShiftAndMatcher::search(const std::string& text, const std::string& pattern) {
+        std::vector<MatchResult> results;
+
+        searchEach(text, pattern, [&](size_t position, int, size_t length, int editDistance) {
+            results.emplace_back(
+                position,
+                text.substr(position, length),
+                editDistance,  // 0 (exact match)
+                "Exact Match",
+                "Shift-And"
+            );
+        });
+
+        return results;
+    }
+
+} // namespace DNACore
\ No newline at end of file
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AnalysisTypes.h"
+#include "IUPACCode.h"
+
+namespace DNACore {
+
+    /**
+     * Shift-And (bit-parallel) matching with IUPAC character classes
+     * Bit i of the state is set when the last i + 1 text bytes match the
+     * first i + 1 pattern positions. Each pattern position is a class of
+     * bytes (see IUPACCode), folded into one mask per byte value, so a
+     * degenerate pattern costs the same single pass as a plain one.
+     * Patterns longer than 64 positions span several state words, with
+     * the shift carried from word to word.
+     * Time Complexity: O(n * ceil(m / 64))
+     * Space Complexity: O(256 * ceil(m / 64)) mask words
+     */
+    class ShiftAndMatcher {
+    public:
+        // Pattern positions held in one state word
+        static constexpr size_t WORD_BITS = 64;
+
+        ShiftAndMatcher();
+        ~ShiftAndMatcher();
+
+        /**
+         * Check whether a pattern can be searched (any non-empty pattern)
+         */
+        static bool canSearch(const std::string& pattern) {
+            return !pattern.empty();
+        }
+
+        /**
+         * Search for a (possibly degenerate) pattern
+         * @return Vector of MatchResult, empty if !canSearch(pattern)
+         */
+        std::vector<MatchResult> search(const std::string& text, const std::string& pattern);
+
+        /**
+         * Allocation-free search: calls sink(position, patternId, length,
+         * editDistance) for every occurrence in ascending order (patternId
+         * and editDistance are always 0)
+         * @return Number of occurrences delivered before the sink stopped
+         */
+        template <typename Sink>
+        size_t searchEach(const char* text, size_t length, const std::string& pattern, Sink&& sink) {
+            charactersRead_ = 0;
+            if (!canSearch(pattern) || pattern.length() > length) {
+                return 0;
+            }
+
+            preparePattern(pattern);
+
+            const size_t m = pattern.length();
+            const uint64_t* masks = masks_.data();
+            const uint64_t matchBit = uint64_t(1) << ((m - 1) % WORD_BITS);
+            size_t found = 0;
+
+            if (words_ == 1) {
+                uint64_t state = 0;
+
+                for (size_t i = 0; i < length; ++i) {
+                    state = ((state << 1) | 1) & masks[static_cast<unsigned char>(text[i])];
+
+                    if (state & matchBit) {
+                        found++;
+                        if (!detail::emitMatch(sink, i + 1 - m, 0, m, 0)) {
+                            charactersRead_ = i + 1;
+                            return found;
+                        }
+                    }
+                }
+
+                charactersRead_ = length;
+                return found;
+            }
+
+            // Word w holds positions 64w..64w+63; each word's top bit
+            // carries into the next word's bottom bit
+            const size_t words = words_;
+            state_.assign(words, 0);
+            uint64_t* state = state_.data();
+
+            for (size_t i = 0; i < length; ++i) {
+                const uint64_t* mask = masks + static_cast<unsigned char>(text[i]) * words;
+                uint64_t carry = 1;
+                for (size_t w = 0; w < words; ++w) {
+                    uint64_t previous = state[w];
+                    state[w] = ((previous << 1) | carry) & mask[w];
+                    carry = previous >> (WORD_BITS - 1);
+                }
+
+                if (state[words - 1] & matchBit) {
+                    found++;
+                    if (!detail::emitMatch(sink, i + 1 - m, 0, m, 0)) {
+                        charactersRead_ = i + 1;
+                        return found;
+                    }
+                }
+            }
+
+            charactersRead_ = length;
+            return found;
+        }
+
+        template <typename Sink>
+        size_t searchEach(const std::string& text, const std::string& pattern, Sink&& sink) {
+            return searchEach(text.data(), text.length(), pattern, sink);
+        }
+
+        /**
+         * Get statistics about the last search
+         */
+        size_t getCharactersRead() const { return charactersRead_; }
+
+    private:
+        std::string pattern_;           // Pattern the masks were built for
+        std::vector<uint64_t> masks_;   // Per byte, words_ words; bit i: byte matches position i
+        std::vector<uint64_t> state_;   // Multiword search state
+        size_t words_;                  // State words per pattern
+        size_t charactersRead_;
+
+        /**
+         * Build the byte masks (kept while the pattern stays the same)
+         */
+        void preparePattern(const std::string& pattern);
+    };
+
+} // namespace DNACore
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "ThreadPool.h"
+
+namespace DNACore {
+
+    namespace {
+
+        // Pool and worker index of the current thread, set by workerLoop()
+        thread_local const ThreadPool* currentPool = nullptr;
+        thread_local size_t currentIndex = 0;
+
+    } // namespace
+
+    ThreadPool::ThreadPool(size_t threadCount)
+        : pending_(0), nextQueue_(0), stopping_(false) {
+        if (threadCount == 0) {
+            threadCount = defaultThreadCount();
+        }
+
+        queues_.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; ++i) {
+            queues_.push_back(std::make_unique<WorkerQueue>());
+        }
+
+        workers_.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; ++i) {
+            workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            stopping_ = true;
+        }
+        condition_.notify_all();
+
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    int ThreadPool::currentWorker() const {
+        return currentPool == this ? static_cast<int>(currentIndex) : -1;
+    }
+
+    void ThreadPool::push(std::function<void()> task) {
+        size_t target = currentPool == this
+            ? currentIndex
+            : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+
+        // Count the task before it becomes visible, so a thief can never
+        // decrement pending_ below zero; publishing under the sleep mutex
+        // means a worker about to wait cannot miss it
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+            pending_.fetch_add(1, std::memory_order_release);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+            queues_[target]->tasks.push_back(std::move(task));
+        }
+
+        condition_.notify_one();
+    }
+
+    bool ThreadPool::tryPop(size_t self, std::function<void()>& task) {
+        // Own deque first, newest task (its data is likely still in cache)
+        {
+            WorkerQueue& own = *queues_[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                pending_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        // Steal the oldest task from another worker
+        for (size_t offset = 1; offset < queues_.size(); ++offset) {
+            WorkerQueue& victim = *queues_[(self + offset) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                pending_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void ThreadPool::workerLoop(size_t index) {
+        currentPool = this;
+        currentIndex = index;
+
+        for (;;) {
+            std::function<void()> task;
+
+            if (tryPop(index, task)) {
+                task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            condition_.wait(lock, [this]() {
+                return stopping_ || pending_.load(std::memory_order_acquire) > 0;
+            });
+
+            // Drain remaining work before shutting down
+            if (stopping_ && pending_.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+
+    ThreadPool& ThreadPool::shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    size_t ThreadPool::defaultThreadCount() {
+        unsigned int count = std::thread::hardware_concurrency();
+        return count == 0 ? 1 : static_cast<size_t>(count);
+    }
+
+} // namespace DNACore
\ No newline at end of file
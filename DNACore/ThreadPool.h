@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace DNACore {
+
+    /**
+     * Fixed-size work-stealing worker pool
+     * Each worker owns a task deque. Tasks submitted from a worker go to
+     * its own deque and are run newest-first; tasks submitted from other
+     * threads are dealt round-robin. Idle workers steal the oldest task
+     * from the other deques, so uneven tasks (short and long records,
+     * chunks with many hits) still keep every core busy.
+     * submit() returns a future for the task's result.
+     */
+    class ThreadPool {
+    public:
+        /**
+         * @param threadCount Number of workers (0 = hardware concurrency)
+         */
+        explicit ThreadPool(size_t threadCount = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * Queue a task for execution on a worker
+         * @return Future holding the task's return value
+         */
+        template <typename Func>
+        auto submit(Func&& func) -> std::future<decltype(func())> {
+            using Result = decltype(func());
+
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+            std::future<Result> future = task->get_future();
+
+            push([task]() { (*task)(); });
+
+            return future;
+        }
+
+        /**
+         * Number of worker threads
+         */
+        size_t size() const { return workers_.size(); }
+
+        /**
+         * Index of the calling worker in this pool, or -1 from other threads
+         * Lets tasks keep per-worker scratch without thread_local state.
+         */
+        int currentWorker() const;
+
+        /**
+         * Process-wide pool sized to the hardware concurrency
+         */
+        static ThreadPool& shared();
+
+        /**
+         * Hardware concurrency, never less than 1
+         */
+        static size_t defaultThreadCount();
+
+    private:
+        /**
+         * One worker's task deque; the owner pops the back, thieves the front
+         */
+        struct WorkerQueue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::thread> workers_;
+        std::vector<std::unique_ptr<WorkerQueue>> queues_;
+        std::atomic<size_t> pending_;        // Queued, not yet started tasks
+        std::atomic<size_t> nextQueue_;      // Round-robin target for external submits
+        std::mutex sleepMutex_;
+        std::condition_variable condition_;
+        bool stopping_;
+
+        /**
+         * Queue a task and wake a sleeping worker
+         */
+        void push(std::function<void()> task);
+
+        /**
+         * Take a task from the own deque, else steal one
+         */
+        bool tryPop(size_t self, std::function<void()>& task);
+
+        void workerLoop(size_t index);
+    };
+
+} // namespace DNACore
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "WindowProfiler.h"
+#include <array>
+
+namespace DNACore {
+
+    namespace {
+
+        constexpr std::array<unsigned char, 256> makeClassTable() {
+            std::array<unsigned char, 256> table{};
+            for (auto& entry : table) {
+                entry = 4;
+            }
+            table['A'] = 0;
+            table['C'] = 1;
+            table['G'] = 2;
+            table['T'] = 3;
+            table['U'] = 3;
+            return table;
+        }
+
+        constexpr std::array<unsigned char, 256> CLASS_TABLE = makeClassTable();
+
+        inline unsigned char classOf(char base) {
+            return CLASS_TABLE[static_cast<unsigned char>(base)];
+        }
+
+    } // namespace
+
+    WindowProfiler::WindowProfiler(size_t windowSize, size_t step)
+        : windowSize_(windowSize == 0 ? 1 : windowSize),
+        step_(step == 0 ? 1 : step),
+        ring_(windowSize == 0 ? 1 : windowSize),
+        reciprocals_(windowSize == 0 ? 1 : windowSize) {
+        reset();
+    }
+
+    WindowProfiler::~WindowProfiler() {
+    }
+
+    void WindowProfiler::reset() {
+        offset_ = 0;
+        nextWindowEnd_ = windowSize_;
+        ringPos_ = 0;
+        for (auto& count : counts_) {
+            count = 0;
+        }
+
+        profile_ = WindowProfile();
+        profile_.windowSize = windowSize_;
+        profile_.step = step_;
+    }
+
+    WindowProfiler::Reciprocals::Reciprocals(size_t windowSize)
+        : percentScale(static_cast<float>(100.0 / windowSize)) {
+        if (windowSize <= MAX_TABLE_SIZE) {
+            inverse.resize(windowSize + 1);
+            inverse[0] = 0.0f;
+            for (size_t k = 1; k <= windowSize; ++k) {
+                inverse[k] = static_cast<float>(1.0 / k);
+            }
+        }
+    }
+
+    void WindowProfiler::emit(WindowProfile& profile, const Reciprocals& reciprocals,
+        size_t a, size_t c, size_t g, size_t t) {
+
+        size_t gc = g + c;
+        size_t at = a + t;
+        float gcDiff = static_cast<float>(static_cast<long long>(g) - static_cast<long long>(c));
+        float atDiff = static_cast<float>(static_cast<long long>(a) - static_cast<long long>(t));
+
+        // Multiplying by a tabulated 1/k avoids two divisions per window
+        float gcInverse = reciprocals.inverse.empty()
+            ? (gc == 0 ? 0.0f : 1.0f / static_cast<float>(gc)) : reciprocals.inverse[gc];
+        float atInverse = reciprocals.inverse.empty()
+            ? (at == 0 ? 0.0f : 1.0f / static_cast<float>(at)) : reciprocals.inverse[at];
+
+        profile.gcContent.push_back(static_cast<float>(gc) * reciprocals.percentScale);
+        profile.gcSkew.push_back(gcDiff * gcInverse);
+        profile.atSkew.push_back(atDiff * atInverse);
+    }
+
+    WindowProfile WindowProfiler::profile(const char* data, size_t length, size_t windowSize, size_t step) {
+        WindowProfile result;
+        result.windowSize = windowSize == 0 ? 1 : windowSize;
+        result.step = step == 0 ? 1 : step;
+
+        const size_t w = result.windowSize;
+        if (length < w) {
+            return result;
+        }
+
+        const Reciprocals reciprocals(w);
+
+        size_t windows = (length - w) / result.step + 1;
+        result.gcContent.reserve(windows);
+        result.gcSkew.reserve(windows);
+        result.atSkew.reserve(windows);
+
+        // Disjoint windows: count each one with the vectorized kernel
+        if (result.step >= w) {
+            for (size_t start = 0; start + w <= length; start += result.step) {
+                BaseComposition composition = CompositionKernel::count(data + start, w);
+                emit(result, reciprocals, composition.adenine, composition.cytosine, composition.guanine,
+                    composition.thymine + composition.uracil);
+            }
+            return result;
+        }
+
+        // Overlapping windows: seed the first window, then slide one base at a time
+        BaseComposition first = CompositionKernel::count(data, w);
+        size_t counts[5] = {
+            first.adenine, first.cytosine, first.guanine,
+            first.thymine + first.uracil, first.unknown + first.other
+        };
+        emit(result, reciprocals, counts[0], counts[1], counts[2], counts[3]);
+
+        size_t untilEmit = result.step;
+        for (size_t i = w; i < length; ++i) {
+            counts[classOf(data[i])]++;
+            counts[classOf(data[i - w])]--;
+
+            if (--untilEmit == 0) {
+                emit(result, reciprocals, counts[0], counts[1], counts[2], counts[3]);
+                untilEmit = result.step;
+            }
+        }
+
+        return result;
+    }
+
+    void WindowProfiler::feed(const char* data, size_t length) {
+        unsigned char* ring = ring_.data();
+
+        for (size_t i = 0; i < length; ++i) {
+            unsigned char incoming = classOf(data[i]);
+
+            // Once the ring is full, the slot being overwritten holds the base leaving the window
+            if (offset_ >= windowSize_) {
+                counts_[ring[ringPos_]]--;
+            }
+            ring[ringPos_] = incoming;
+            counts_[incoming]++;
+
+            if (++ringPos_ == windowSize_) {
+                ringPos_ = 0;
+            }
+
+            if (++offset_ == nextWindowEnd_) {
+                emit(profile_, reciprocals_, counts_[CLASS_A], counts_[CLASS_C], counts_[CLASS_G], counts_[CLASS_T]);
+                nextWindowEnd_ += step_;
+            }
+        }
+    }
+
+    WindowProfile WindowProfiler::take() {
+        WindowProfile taken = std::move(profile_);
+
+        profile_ = WindowProfile();
+        profile_.windowSize = windowSize_;
+        profile_.step = step_;
+        profile_.firstWindow = taken.firstWindow + taken.size();
+
+        return taken;
+    }
+
+} // namespace DNACore
\ No newline at end of file
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "CompositionKernel.h"
+
+namespace DNACore {
+
+    /**
+     * Per-window composition profile
+     * Window i covers [startOf(i), startOf(i) + windowSize). Each value is
+     * stored as a float, 12 bytes per window for all three tracks.
+     */
+    struct WindowProfile {
+        size_t windowSize;
+        size_t step;
+        size_t firstWindow;           // Global index of element 0 (streaming batches)
+        std::vector<float> gcContent; // (G + C) / windowSize * 100
+        std::vector<float> gcSkew;    // (G - C) / (G + C), 0 if no G or C
+        std::vector<float> atSkew;    // (A - T) / (A + T), U counted as T, 0 if no A or T
+
+        WindowProfile() : windowSize(0), step(0), firstWindow(0) {}
+
+        size_t size() const { return gcContent.size(); }
+        bool empty() const { return gcContent.empty(); }
+        size_t startOf(size_t index) const { return (firstWindow + index) * step; }
+    };
+
+    /**
+     * Sliding-window GC content, GC skew and AT skew
+     * Counts are kept as running totals (one base in, one base out), so a
+     * profile costs O(n) regardless of window size, even at a 1 bp step.
+     * When step >= windowSize the windows do not overlap and each one is
+     * counted directly with CompositionKernel. Bases are classified like
+     * getStatistics() (uppercase A, C, G, T, U; everything else only
+     * counts towards the window length).
+     *
+     * Streaming mode: feed() sequence chunks as they arrive (e.g. from
+     * FASTAParser::streamChunks) and take() the completed windows
+     * periodically; memory stays at windowSize bytes plus the windows not
+     * yet taken.
+     */
+    class WindowProfiler {
+    public:
+        /**
+         * @param windowSize Bases per window (>= 1)
+         * @param step Distance between window starts (>= 1)
+         */
+        WindowProfiler(size_t windowSize, size_t step = 1);
+        ~WindowProfiler();
+
+        /**
+         * Profile a whole in-memory sequence
+         */
+        static WindowProfile profile(const char* data, size_t length, size_t windowSize, size_t step = 1);
+
+        static WindowProfile profile(const std::string& sequence, size_t windowSize, size_t step = 1) {
+            return profile(sequence.data(), sequence.length(), windowSize, step);
+        }
+
+        /**
+         * Append the next chunk of the stream
+         */
+        void feed(const char* data, size_t length);
+
+        void feed(const std::string& chunk) { feed(chunk.data(), chunk.length()); }
+
+        /**
+         * Windows completed since the last take()
+         */
+        const WindowProfile& current() const { return profile_; }
+
+        /**
+         * Move out the completed windows; the stream position is kept
+         */
+        WindowProfile take();
+
+        /**
+         * Start a new stream (e.g. at the next record)
+         */
+        void reset();
+
+        /**
+         * Bases consumed since the last reset()
+         */
+        size_t getOffset() const { return offset_; }
+
+    private:
+        // Running-count classes: A, C, G, T/U, other
+        enum BaseClass : unsigned char {
+            CLASS_A = 0,
+            CLASS_C,
+            CLASS_G,
+            CLASS_T,
+            CLASS_OTHER
+        };
+
+        size_t windowSize_;
+        size_t step_;
+        size_t offset_;
+        size_t nextWindowEnd_;                // Offset at which the next window completes
+        size_t ringPos_;                      // Slot of the oldest base in ring_
+        size_t counts_[CLASS_OTHER + 1];
+        std::vector<unsigned char> ring_;     // Classes of the last windowSize bases
+        WindowProfile profile_;
+
+        /**
+         * 100 / windowSize and a table of 1/k for k <= windowSize
+         * (the table is skipped for very large windows)
+         */
+        struct Reciprocals {
+            static constexpr size_t MAX_TABLE_SIZE = 1 << 20;
+
+            float percentScale;
+            std::vector<float> inverse;
+
+            explicit Reciprocals(size_t windowSize);
+        };
+
+        Reciprocals reciprocals_;
+
+        /**
+         * Append one window's values from its counts
+         */
+        static void emit(WindowProfile& profile, const Reciprocals& reciprocals,
+            size_t a, size_t c, size_t g, size_t t);
+    };
+
+} // namespace DNACore
\ No newline at end of file
@@ -19,6 +19,7 @@ namespace DNACoreBridge {
         property int EditDistance;
         property String^ MotifType;
         property String^ Algorithm;
+        property Char Strand;           // '+' or '-' (reverse complement)
 
         ManagedMatchResult() {
             Position = 0;
@@ -26,6 +27,7 @@ namespace DNACoreBridge {
             MatchedSequence = "";
             MotifType = "";
             Algorithm = "";
+            Strand = '+';
         }
 
         ManagedMatchResult(int pos, String^ seq, int dist, String^ type, String^ algo) {
@@ -34,6 +36,7 @@ namespace DNACoreBridge {
             EditDistance = dist;
             MotifType = type;
             Algorithm = algo;
+            Strand = '+';
         }
     };
 
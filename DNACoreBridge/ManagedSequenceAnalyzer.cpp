@@ -147,6 +147,7 @@ namespace DNACoreBridge {
                 TypeConverters::ToManagedString(nativeResult.motifType),
                 TypeConverters::ToManagedString(nativeResult.algorithm)
             );
+            managedResult->Strand = nativeResult.strand;
             managedResults->Add(managedResult);
         }
 
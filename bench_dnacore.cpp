@@ -0,0 +1,442 @@
+// bench_dnacore.cpp : Throughput benchmarks for the DNACore algorithms
+//
+// Generates reproducible synthetic genomes (uniform, GC-skewed, repeat-rich)
+// and times each public entry point, reporting MB/s, hits/s, peak RSS and
+// heap allocations. Results go to stdout as a table and, with --json, to a
+// machine-readable file for regression tracking.
+//
+// Usage: bench_dnacore [--sizes 1K,1M,16M] [--profiles uniform,gc,repeat]
+//                      [--iterations N] [--seed N] [--json out.json]
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "DNACore/SequenceAnalyzer.h"
+#include "DNACore/BatchAnalyzer.h"
+#include "DNACore/FASTAParser.h"
+#include "DNACore/InputValidator.h"
+#include "DNACore/PackedSequence.h"
+
+// ===== ALLOCATION COUNTING =====
+
+static std::atomic<size_t> g_allocations(0);
+static std::atomic<size_t> g_allocatedBytes(0);
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
+
+using namespace DNACore;
+
+namespace {
+
+    // ===== SYSTEM METRICS =====
+
+    size_t peakRssBytes() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return static_cast<size_t>(counters.PeakWorkingSetSize);
+        }
+        return 0;
+#else
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return static_cast<size_t>(usage.ru_maxrss);
+#else
+        return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+    }
+
+    // ===== SYNTHETIC GENOMES =====
+
+    /**
+     * xorshift64* - fast and identical on every platform for a given seed
+     */
+    class Random {
+    public:
+        explicit Random(uint64_t seed) : state_(seed ? seed : 0x9E3779B97F4A7C15ULL) {}
+
+        uint64_t next() {
+            state_ ^= state_ >> 12;
+            state_ ^= state_ << 25;
+            state_ ^= state_ >> 27;
+            return state_ * 0x2545F4914F6CDD1DULL;
+        }
+
+        size_t below(size_t bound) { return static_cast<size_t>(next() % bound); }
+
+    private:
+        uint64_t state_;
+    };
+
+    std::string generateUniform(size_t length, Random& rng) {
+        static const char BASES[] = "ACGT";
+        std::string seq(length, 'A');
+        for (size_t i = 0; i < length; ) {
+            uint64_t bits = rng.next();
+            for (int b = 0; b < 32 && i < length; ++b, ++i, bits >>= 2) {
+                seq[i] = BASES[bits & 3];
+            }
+        }
+        return seq;
+    }
+
+    std::string generateGCSkewed(size_t length, Random& rng) {
+        // ~65% GC, as in GC-rich isochores and CpG islands
+        std::string seq(length, 'A');
+        for (size_t i = 0; i < length; ++i) {
+            uint64_t r = rng.next() % 100;
+            if (r < 33) seq[i] = 'G';
+            else if (r < 65) seq[i] = 'C';
+            else if (r < 83) seq[i] = 'A';
+            else seq[i] = 'T';
+        }
+        return seq;
+    }
+
+    std::string generateRepeatRich(size_t length, Random& rng) {
+        // Uniform background with tandem repeats and interspersed motif copies
+        static const char* ELEMENTS[] = {
+            "TATAAA", "GGCCAATCT", "GGGCGG", "GCCACCATGG", "AATAAA",
+            "CA", "AT", "GGC", "TTAGGG"
+        };
+
+        std::string seq = generateUniform(length, rng);
+        size_t pos = 0;
+        while (pos < length) {
+            pos += 20 + rng.below(200);
+            const char* unit = ELEMENTS[rng.below(sizeof(ELEMENTS) / sizeof(ELEMENTS[0]))];
+            size_t unitLength = std::char_traits<char>::length(unit);
+            size_t copies = 1 + rng.below(unitLength < 4 ? 30 : 4);
+            for (size_t c = 0; c < copies && pos + unitLength <= length; ++c) {
+                seq.replace(pos, unitLength, unit);
+                pos += unitLength;
+            }
+        }
+        return seq;
+    }
+
+    std::string generateGenome(const std::string& profile, size_t length, uint64_t seed) {
+        Random rng(seed);
+        if (profile == "gc") return generateGCSkewed(length, rng);
+        if (profile == "repeat") return generateRepeatRich(length, rng);
+        return generateUniform(length, rng);
+    }
+
+    // ===== RESULTS =====
+
+    struct BenchResult {
+        std::string operation;
+        std::string profile;
+        size_t bytes;
+        double seconds;
+        size_t hits;
+        size_t allocations;
+        size_t allocatedBytes;
+        size_t peakRss;
+
+        double mbPerSecond() const { return seconds > 0 ? bytes / 1e6 / seconds : 0.0; }
+        double hitsPerSecond() const { return seconds > 0 ? hits / seconds : 0.0; }
+    };
+
+    /**
+     * Time the best of N runs; allocations are taken from the last run
+     */
+    BenchResult measure(const std::string& operation, const std::string& profile, size_t bytes,
+        int iterations, const std::function<size_t()>& body) {
+
+        BenchResult result{ operation, profile, bytes, 0.0, 0, 0, 0, 0 };
+        double best = -1.0;
+
+        for (int it = 0; it < iterations; ++it) {
+            size_t allocsBefore = g_allocations.load();
+            size_t bytesBefore = g_allocatedBytes.load();
+
+            auto start = std::chrono::steady_clock::now();
+            size_t hits = body();
+            auto stop = std::chrono::steady_clock::now();
+
+            double seconds = std::chrono::duration<double>(stop - start).count();
+            if (best < 0 || seconds < best) {
+                best = seconds;
+            }
+
+            result.hits = hits;
+            result.allocations = g_allocations.load() - allocsBefore;
+            result.allocatedBytes = g_allocatedBytes.load() - bytesBefore;
+        }
+
+        result.seconds = best;
+        result.peakRss = peakRssBytes();
+        return result;
+    }
+
+    size_t parseSize(const std::string& text) {
+        size_t value = std::strtoull(text.c_str(), nullptr, 10);
+        char suffix = text.empty() ? '\0' : text.back();
+        switch (suffix) {
+        case 'K': case 'k': return value * 1024;
+        case 'M': case 'm': return value * 1024 * 1024;
+        case 'G': case 'g': return value * 1024 * 1024 * 1024;
+        default: return value;
+        }
+    }
+
+    std::vector<std::string> splitList(const std::string& text) {
+        std::vector<std::string> items;
+        std::stringstream stream(text);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            if (!item.empty()) items.push_back(item);
+        }
+        return items;
+    }
+
+    std::string writeFASTA(const std::string& sequence) {
+        std::string path = "bench_dnacore_tmp.fa";
+        std::ofstream out(path, std::ios::binary);
+        out << ">bench synthetic genome\n";
+        for (size_t i = 0; i < sequence.length(); i += 60) {
+            out.write(sequence.data() + i, std::min<size_t>(60, sequence.length() - i));
+            out << '\n';
+        }
+        return path;
+    }
+
+    void writeJSON(std::ostream& out, const std::vector<BenchResult>& results, uint64_t seed) {
+        out << "{\n  \"benchmark\": \"dnacore\",\n  \"seed\": " << seed << ",\n  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const auto& r = results[i];
+            out << "    {\"operation\": \"" << r.operation << "\""
+                << ", \"profile\": \"" << r.profile << "\""
+                << ", \"bytes\": " << r.bytes
+                << ", \"seconds\": " << r.seconds
+                << ", \"mb_per_s\": " << r.mbPerSecond()
+                << ", \"hits\": " << r.hits
+                << ", \"hits_per_s\": " << r.hitsPerSecond()
+                << ", \"allocations\": " << r.allocations
+                << ", \"allocated_bytes\": " << r.allocatedBytes
+                << ", \"peak_rss_bytes\": " << r.peakRss
+                << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> sizeArgs = { "1K", "64K", "1M", "16M" };
+    std::vector<std::string> profiles = { "uniform", "gc", "repeat" };
+    int iterations = 3;
+    uint64_t seed = 42;
+    std::string jsonPath;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string value = i + 1 < argc ? argv[i + 1] : "";
+        if (arg == "--sizes") { sizeArgs = splitList(value); ++i; }
+        else if (arg == "--profiles") { profiles = splitList(value); ++i; }
+        else if (arg == "--iterations") { iterations = std::max(1, std::atoi(value.c_str())); ++i; }
+        else if (arg == "--seed") { seed = std::strtoull(value.c_str(), nullptr, 10); ++i; }
+        else if (arg == "--json") { jsonPath = value; ++i; }
+        else {
+            std::cerr << "Usage: " << argv[0]
+                << " [--sizes 1K,1M,1G] [--profiles uniform,gc,repeat]"
+                << " [--iterations N] [--seed N] [--json out.json]" << std::endl;
+            return 1;
+        }
+    }
+
+    const std::string exactPattern = "TATAAAGG";
+    const std::string degeneratePattern = "TATAWAWR";
+    const std::string approxPattern = "GGCCAATCTGGGCGGG";
+    const std::string regexPattern = "TATA[AT]A[AT]|GGGCGG.{0,40}CCAAT";
+    const int approxDistance = 2;
+
+    FASTAParser::Config parserConfig;
+    parserConfig.maxFileSize = 0;
+    parserConfig.validatorConfig.maxLength = 0;
+    FASTAParser parser(parserConfig);
+
+    InputValidator::Config validatorConfig;
+    validatorConfig.maxLength = 0;
+    InputValidator validator(validatorConfig);
+
+    std::vector<BenchResult> results;
+
+    std::printf("%-18s %-8s %12s %10s %12s %12s %12s %10s\n",
+        "operation", "profile", "bytes", "MB/s", "hits", "hits/s", "allocs", "peakRSS MB");
+
+    for (const auto& sizeArg : sizeArgs) {
+        size_t size = parseSize(sizeArg);
+
+        for (const auto& profile : profiles) {
+            std::string genome = generateGenome(profile, size, seed);
+
+            SequenceAnalyzer analyzer;
+            analyzer.setSequence(genome);
+            std::string fastaPath = writeFASTA(genome);
+
+            std::vector<BenchResult> batch;
+
+            batch.push_back(measure("exactMatch", profile, size, iterations, [&]() {
+                return analyzer.exactMatch(exactPattern).size();
+            }));
+            batch.push_back(measure("degenerateMatch", profile, size, iterations, [&]() {
+                return analyzer.exactMatch(degeneratePattern).size();
+            }));
+            batch.push_back(measure("approximateMatch", profile, size, iterations, [&]() {
+                return analyzer.approximateMatch(approxPattern, approxDistance).size();
+            }));
+            batch.push_back(measure("searchAllMotifs", profile, size, iterations, [&]() {
+                return analyzer.searchAllMotifs().size();
+            }));
+            batch.push_back(measure("pushdownSearch", profile, size, iterations, [&]() {
+                return analyzer.pushdownSearch(exactPattern).size();
+            }));
+            batch.push_back(measure("getStatistics", profile, size, iterations, [&]() {
+                auto stats = analyzer.getStatistics();
+                size_t hits = 0;
+                for (const auto& motif : stats.motifs) hits += motif.count;
+                return hits;
+            }));
+            batch.push_back(measure("parseFile", profile, size, iterations, [&]() {
+                return parser.parseFile(fastaPath).totalRecords();
+            }));
+            batch.push_back(measure("streamFileChunks", profile, size, iterations, [&]() {
+                return parser.streamFileChunks(fastaPath, 0, [](const FASTAChunk&) { return true; }).basesRead;
+            }));
+            batch.push_back(measure("mapFile", profile, size, iterations, [&]() {
+                MappedFASTA mapped = parser.mapFile(fastaPath);
+                return mapped.recordCount() > 0 ? mapped.record(0).length : size_t(0);
+            }));
+            batch.push_back(measure("validate", profile, size, iterations, [&]() {
+                return validator.validate(genome).isValid ? size_t(1) : size_t(0);
+            }));
+            batch.push_back(measure("pack", profile, size, iterations, [&]() {
+                return PackedSequence(genome).memoryUsage();
+            }));
+
+            PackedSequence packed(genome);
+            KMPMatcher packedMatcher;
+            batch.push_back(measure("packedExactMatch", profile, size, iterations, [&]() {
+                return packedMatcher.searchEach(packed, exactPattern, [](size_t, int, size_t, int) {});
+            }));
+
+            batch.push_back(measure("buildIndex", profile, size, iterations, [&]() {
+                FMIndex index;
+                index.build(genome);
+                return index.memoryUsage();
+            }));
+
+            SequenceAnalyzer indexed;
+            AnalysisOptions indexedOptions;
+            indexedOptions.useIndex = true;
+            indexed.setSequence(genome);
+            indexed.setOptions(indexedOptions);
+            indexed.buildIndex();
+            batch.push_back(measure("indexedExactMatch", profile, size, iterations, [&]() {
+                return indexed.exactMatch(exactPattern).size();
+            }));
+
+            batch.push_back(measure("regexSearch", profile, size, iterations, [&]() {
+                return analyzer.regexSearch(regexPattern).size();
+            }));
+
+            // Loose enough for the six-base motifs (see MotifDatabase::getAllMatrices)
+            PWMScanner::Config pwmConfig;
+            pwmConfig.pValue = 1e-3;
+            PWMScanner pwmScanner(pwmConfig);
+            pwmScanner.addMatrices(MotifDatabase::getAllMatrices());
+            batch.push_back(measure("pwmScan", profile, size, iterations, [&]() {
+                return pwmScanner.scanEach(genome, [](const PWMHit&) {});
+            }));
+
+            // Transcript-sized records analyzed concurrently
+            std::vector<FASTARecord> records;
+            for (size_t offset = 0; offset < genome.length(); offset += 2000) {
+                FASTARecord record;
+                record.description = "r" + std::to_string(records.size());
+                record.sequence = genome.substr(offset, 2000);
+                records.push_back(std::move(record));
+            }
+            BatchAnalyzer batchAnalyzer({ BatchAnalysis::motifs(), BatchAnalysis::statistics(),
+                BatchAnalysis::exactMatch(exactPattern) });
+            batch.push_back(measure("batchAnalyze", profile, size, iterations, [&]() {
+                size_t hits = 0;
+                for (const auto& result : batchAnalyzer.analyze(records)) {
+                    hits += result.matches[0].size() + result.matches[2].size();
+                }
+                return hits;
+            }));
+
+            std::remove(fastaPath.c_str());
+
+            for (const auto& r : batch) {
+                std::printf("%-18s %-8s %12zu %10.1f %12zu %12.0f %12zu %10.1f\n",
+                    r.operation.c_str(), r.profile.c_str(), r.bytes, r.mbPerSecond(),
+                    r.hits, r.hitsPerSecond(), r.allocations, r.peakRss / (1024.0 * 1024.0));
+                results.push_back(r);
+            }
+        }
+    }
+
+    if (!jsonPath.empty()) {
+        std::ofstream out(jsonPath);
+        if (!out.is_open()) {
+            std::cerr << "Failed to open " << jsonPath << std::endl;
+            return 1;
+        }
+        writeJSON(out, results, seed);
+        std::cout << "\nJSON written to " << jsonPath << std::endl;
+    }
+
+    return 0;
+}
@@ -1,6 +1,9 @@
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <vector>
 #include "DNACore/AhoCorasick.h"
+#include "test_checks.h"
 
 using namespace DNACore;
 
@@ -30,6 +33,110 @@ int main() {
                   << ": " << result.matchedSequence 
                   << " (" << result.motifType << ")" << std::endl;
     }
-    
-    return 0;
+
+    // Nested patterns share one output chain; matches come longest first
+    std::cout << "\n=== Nested patterns ===" << std::endl;
+    {
+        AhoCorasick nested;
+        for (size_t length = 1; length <= 50; ++length) {
+            nested.addPattern(std::string(length, 'A'), "A" + std::to_string(length));
+        }
+        nested.addPattern("AAA", "A3 again");
+        nested.buildAutomaton();
+
+        std::vector<size_t> lengths;
+        nested.scanEach(std::string(60, 'A'), [&](size_t, int, size_t length, int) {
+            lengths.push_back(length);
+        });
+
+        // Every end position e reports min(e, 50) patterns, plus the duplicate
+        size_t expected = 0;
+        for (size_t end = 1; end <= 60; ++end) {
+            expected += std::min<size_t>(end, 50) + (end >= 3 ? 1 : 0);
+        }
+        bool ordered = true;
+        for (size_t i = 1; i < lengths.size(); ++i) {
+            ordered &= lengths[i] <= lengths[i - 1] || lengths[i - 1] == 1;
+        }
+        check(lengths.size() == expected, "every nested match reported (" + std::to_string(expected) + ")");
+        check(ordered, "matches ending together come longest first");
+    }
+
+    // Both strands in one automaton; a palindrome is one pattern and one hit
+    std::cout << "\n=== Both strands ===" << std::endl;
+    {
+        AhoCorasick strands;
+        strands.addBothStrands("GAATTC", "EcoRI");
+        strands.addBothStrands("TATAAA", "TATA");
+        check(strands.getPatternCount() == 3, "palindrome GAATTC added once");
+        strands.buildAutomaton();
+
+        auto found = strands.search("CCGAATTCGGTTTATACC");
+        check(found.size() == 2, "one hit per site");
+        check(found.size() == 2 && found[0].position == 2 && found[0].strand == '+',
+            "GAATTC reported once, on the plus strand");
+        check(found.size() == 2 && found[1].position == 10 && found[1].strand == '-'
+            && found[1].matchedSequence == "TTTATA", "TATAAA found as TTTATA on the minus strand");
+    }
+
+    // N in a pattern also matches N in the text
+    std::cout << "\n=== N in the text ===" << std::endl;
+    {
+        AhoCorasick gap;
+        gap.addPattern("GNNC", "Gap");
+        gap.buildAutomaton();
+        auto found = gap.search("AGNNCAGTAC");
+        check(found.size() == 2 && found[0].position == 1 && found[1].position == 6, "GNNC finds GNNC and GTAC");
+    }
+
+    // Degenerate runs longer than the subset construction allows fall back
+    // to Shift-And words, with the same hits in the same order
+    std::cout << "\n=== Long degenerate patterns ===" << std::endl;
+    {
+        std::string longPattern = "A" + std::string(63, 'N') + "T";
+        std::string genome = randomBases(20000, 7);
+
+        AhoCorasick mixed;
+        mixed.addPattern(longPattern, "Long");
+        mixed.addPattern("TATAWAWR", "TATA");
+        mixed.addPattern("GGGCGG", "GC Box");
+        mixed.buildAutomaton();
+        check(mixed.getBitParallelPatternCount() == 2, "degenerate patterns moved to Shift-And");
+        check(mixed.getStateCount() <= AhoCorasick::MAX_CLASS_STATES, "state count capped");
+
+        // Brute force: patterns ending at each position, longest first
+        std::vector<std::pair<size_t, std::string>> expected;
+        for (size_t end = 1; end <= genome.length(); ++end) {
+            for (const std::string& pattern : { longPattern, std::string("TATAWAWR"), std::string("GGGCGG") }) {
+                if (pattern.length() > end) {
+                    continue;
+                }
+                size_t start = end - pattern.length();
+                bool match = true;
+                for (size_t i = 0; i < pattern.length() && match; ++i) {
+                    match = IUPACCode::matches(pattern[i], genome[start + i]);
+                }
+                if (match) {
+                    expected.emplace_back(start, pattern);
+                }
+            }
+        }
+
+        auto found = mixed.search(genome);
+        bool same = found.size() == expected.size();
+        for (size_t i = 0; same && i < found.size(); ++i) {
+            same = found[i].position == expected[i].first && found[i].matchedSequence == expected[i].second;
+        }
+        check(same, "fallback hits match brute force (" + std::to_string(expected.size()) + ")");
+
+        // Chunked input carries the Shift-And words across feeds
+        AhoCorasick::Scanner scanner(mixed);
+        size_t streamed = 0;
+        for (size_t offset = 0; offset < genome.length(); offset += 1000) {
+            streamed += scanner.feed(genome.data() + offset, 1000).size();
+        }
+        check(streamed == expected.size(), "streaming fallback finds every hit");
+    }
+
+    return checkSummary();
 }
@@ -0,0 +1,33 @@
+#pragma once
+
+// Shared helpers of the test programs: pass/fail reporting and
+// reproducible input
+
+#include <iostream>
+#include <string>
+
+inline int failures = 0;
+
+inline void check(bool condition, const std::string& what) {
+    std::cout << (condition ? "  PASS: " : "  FAIL: ") << what << std::endl;
+    if (!condition) {
+        failures++;
+    }
+}
+
+// Reproducible pseudo-random bases
+inline std::string randomBases(size_t length, unsigned seed) {
+    std::string text;
+    text.reserve(length);
+    for (size_t i = 0; i < length; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        text += "ACGT"[(seed >> 16) & 3];
+    }
+    return text;
+}
+
+// Print the summary line; the return value is the program's exit code
+inline int checkSummary() {
+    std::cout << "\n" << (failures == 0 ? "All checks passed" : "Checks failed: " + std::to_string(failures)) << std::endl;
+    return failures == 0 ? 0 : 1;
+}
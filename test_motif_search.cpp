@@ -1,10 +1,37 @@
+#include <climits>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <string>
+#include <tuple>
+#include <vector>
 #include "DNACore/AhoCorasick.h"
+#include "DNACore/FASTAParser.h"
+#include "DNACore/InputValidator.h"
 #include "DNACore/MotifDatabase.h"
+#include "DNACore/SequenceAnalyzer.h"
+#include "test_checks.h"
 
 using namespace DNACore;
 
+// Position and length of every hit, for comparing search paths
+static std::vector<std::pair<size_t, size_t>> spans(const std::vector<MatchResult>& results) {
+    std::vector<std::pair<size_t, size_t>> out;
+    for (const auto& result : results) {
+        out.emplace_back(result.position, result.matchedSequence.length());
+    }
+    return out;
+}
+
+// Every regex hit of a configured matcher
+static std::vector<std::pair<size_t, size_t>> regexSpans(RegexMatcher& matcher, const std::string& text) {
+    std::vector<std::pair<size_t, size_t>> out;
+    matcher.searchEach(text, [&](size_t position, int, size_t length, int) {
+        out.emplace_back(position, length);
+    });
+    return out;
+}
+
 int main() {
     // EXACT sequence from the screenshot
     std::string sequence = "TATAAAGGCCAATCTGGGCGGGCCACCATGGAATAAAAAAAAATATAGGGCGGAAUAAA";
@@ -47,6 +74,343 @@ int main() {
                   << ": '" << result.matchedSequence << "'"
                   << " (" << result.motifType << ")" << std::endl;
     }
-    
-    return 0;
+
+    // Degenerate patterns of any length run in one Shift-And pass
+    std::cout << "\n=== Degenerate exact search ===" << std::endl;
+    {
+        std::string genome = randomBases(50000, 11);
+        SequenceAnalyzer analyzer;
+        analyzer.setSequence(genome);
+
+        for (size_t length : { 8, 64, 65, 66, 130 }) {
+            std::string pattern = "A" + std::string(length - 2, 'N') + "T";
+            size_t expected = 0;
+            for (size_t i = 0; i + length <= genome.length(); ++i) {
+                if (genome[i] == 'A' && genome[i + length - 1] == 'T') {
+                    expected++;
+                }
+            }
+
+            std::string label = std::to_string(length) + "-base N run";
+            check(analyzer.exactMatch(pattern).size() == expected, label + ": exactMatch");
+            check(analyzer.countExactMatches(pattern) == expected, label + ": countExactMatches");
+            check(analyzer.hasExactMatch(pattern) == (expected != 0), label + ": hasExactMatch");
+            check(analyzer.exactMatchCompact(pattern).size() == expected, label + ": exactMatchCompact");
+        }
+
+        // A pattern code always matches the same code in the text
+        analyzer.setSequence("ACGTNNNNACGT");
+        std::vector<size_t> positions;
+        for (const auto& result : analyzer.exactMatch("NNNN")) {
+            positions.push_back(result.position);
+        }
+        check(positions.size() == 9 && positions[4] == 4, "NNNN matches every window, the N run included");
+
+        auto flanked = analyzer.exactMatch("TNNNNA");
+        check(flanked.size() == 1 && flanked[0].position == 3, "TNNNNA finds the N run between T and A");
+
+        analyzer.setSequence("GGRRGG");
+        check(analyzer.countExactMatches("GRRG") == 1, "R in the pattern matches R in the text");
+        check(analyzer.countExactMatches("GYYG") == 0, "other ambiguity codes still do not match");
+    }
+
+    // Minus-strand motif sites come from the same scan, at forward coordinates
+    std::cout << "\n=== Both-strand motif search ===" << std::endl;
+    {
+        SequenceAnalyzer analyzer;
+        analyzer.setSequence("CCTTTATACC");
+        auto minus = analyzer.searchMotif(MotifDatabase::TATA_BOX);
+        check(minus.size() == 1 && minus[0].position == 2 && minus[0].strand == '-',
+            "TATAAA on the minus strand reported at its forward position with strand '-'");
+
+        AnalysisOptions forwardOnly;
+        forwardOnly.bothStrands = false;
+        analyzer.setOptions(forwardOnly);
+        check(analyzer.searchMotif(MotifDatabase::TATA_BOX).empty(), "bothStrands = false ignores the minus strand");
+
+        // Forward-only counts are the plain substring counts, both strands add the reverse complements
+        std::string genome = randomBases(100000, 61);
+        analyzer.setSequence(genome);
+        size_t forward = 0;
+        size_t reverse = 0;
+        for (const auto& motif : MotifDatabase::getAllMotifs()) {
+            std::string rc = IUPACCode::reverseComplement(motif.pattern);
+            for (size_t i = 0; i + motif.pattern.length() <= genome.length(); ++i) {
+                forward += genome.compare(i, motif.pattern.length(), motif.pattern) == 0;
+                reverse += genome.compare(i, rc.length(), rc) == 0;
+            }
+        }
+        check(analyzer.searchAllMotifs().size() == forward && analyzer.countMotifs() == forward,
+            "bothStrands = false keeps single-strand counts (" + std::to_string(forward) + ")");
+
+        analyzer.setOptions(AnalysisOptions());
+        check(analyzer.countMotifs() == forward + reverse,
+            "both strands add the reverse-complement sites (" + std::to_string(reverse) + ")");
+    }
+
+    // Edit distances beyond the pattern length behave like the length
+    std::cout << "\n=== Approximate search bounds ===" << std::endl;
+    {
+        SequenceAnalyzer analyzer;
+        analyzer.setSequence("ACGTACGT");
+        check(analyzer.approximateMatch("ACG", INT_MAX).size() == 8, "maxDistance INT_MAX reports every end position");
+        check(analyzer.countApproximateMatches("ACG", INT_MAX) == analyzer.countApproximateMatches("ACG", 3),
+            "maxDistance INT_MAX counts like maxDistance m");
+    }
+
+    // Compact hits store 16-bit lengths and 8-bit distances
+    std::cout << "\n=== Compact search limits ===" << std::endl;
+    {
+        std::string genome(MatchHit::MAX_LENGTH + 10, 'A');
+        SequenceAnalyzer analyzer;
+        analyzer.setSequence(genome);
+
+        std::string longest(MatchHit::MAX_LENGTH, 'A');
+        CompactMatchResults fits = analyzer.exactMatchCompact(longest);
+        check(fits.size() == 11 && fits.hits[0].length == MatchHit::MAX_LENGTH, "pattern of MAX_LENGTH is stored");
+        check(analyzer.exactMatchCompact(longest + "A").size() == 0, "longer exact pattern is rejected");
+        check(analyzer.exactMatch(longest + "A").size() == 10, "exactMatch still finds it");
+
+        analyzer.setSequence(randomBases(1000, 5));
+        check(analyzer.approximateMatchCompact("ACGTACGT", MatchHit::MAX_EDIT_DISTANCE + 1).size() == 0,
+            "edit distance above MAX_EDIT_DISTANCE is rejected");
+        check(analyzer.approximateMatchCompact("ACGTACGT", 2).size() == analyzer.approximateMatch("ACGTACGT", 2).size(),
+            "approximateMatchCompact agrees within limits");
+    }
+
+    // Validation messages and their order are part of the interface
+    std::cout << "\n=== Input validation messages ===" << std::endl;
+    {
+        struct Case {
+            const char* label;
+            InputValidator::Config config;
+            std::string input;
+            bool valid;
+            std::string cleaned;
+            std::vector<std::string> errors;
+            std::vector<std::string> warnings;
+        };
+
+        InputValidator::Config strict;
+        InputValidator::Config ambiguous;
+        ambiguous.allowAmbiguous = true;
+        InputValidator::Config bounded;
+        bounded.minLength = 10;
+        bounded.maxLength = 12;
+        InputValidator::Config mixed = ambiguous;
+        mixed.minLength = 20;
+        InputValidator::Config upper;
+        upper.strictMode = false;
+        upper.autoUppercase = true;
+
+        const std::string lowercase =
+            "Lowercase letters are not allowed. Please use uppercase nucleotides only (A, T, G, C, U, N)";
+        std::vector<Case> cases = {
+            { "lowercase rejected", strict, "ACGTacgt", false, "", { lowercase }, {} },
+            { "whitespace removed", strict, "AC GT\nAC\tGT\r\n", true, "ACGTACGT", {}, {} },
+            { "invalid characters", strict, "ACXGT1-T", false, "ACXGT1-T",
+                { "Invalid characters found: 'X1-' (3 occurrences)" }, {} },
+            { "ambiguity codes not allowed", strict, "ACGTNNRY", false, "ACGTNNRY", {}, {} },
+            { "ambiguity codes allowed", ambiguous, "ACGTNNRYKM", true, "ACGTNNRYKM", {},
+                { "Ambiguous bases (N, R, Y, etc.): 6 (60.000000%)" } },
+            { "too short", bounded, "ACGT", false, "ACGT", { "Sequence too short: 4 bp (minimum: 10)" }, {} },
+            { "too long", bounded, "ACGTACGTACGTACGT", false, "ACGTACGTACGTACGT",
+                { "Sequence too long: 16 bp (maximum: 12)" }, {} },
+            { "several problems", mixed, "AC NN\nXZ GT", false, "ACNNXZGT",
+                { "Sequence too short: 8 bp (minimum: 20)", "Invalid characters found: 'XZ' (2 occurrences)" },
+                { "Ambiguous bases (N, R, Y, etc.): 2 (25.000000%)" } },
+            { "uppercased", upper, "acgtNacgu", false, "ACGTNACGU", {}, {} },
+            { "empty", strict, "", false, "", { "Sequence is empty" }, {} },
+            { "only whitespace", strict, " \n\t", false, "", { "Sequence too short: 0 bp (minimum: 1)" }, {} },
+        };
+
+        for (const auto& c : cases) {
+            InputValidator validator(c.config);
+            ValidationResult copied = validator.validate(c.input);
+            check(copied.isValid == c.valid && copied.cleanedSequence == c.cleaned
+                && copied.errors == c.errors && copied.warnings == c.warnings,
+                std::string("validate: ") + c.label);
+
+            // In place the input becomes the cleaned sequence (not checked after a rejection)
+            std::string buffer = c.input;
+            ValidationResult inPlace = validator.validateInPlace(buffer);
+            check(inPlace.isValid == c.valid && inPlace.errors == c.errors && inPlace.warnings == c.warnings
+                && (c.errors == std::vector<std::string>{ lowercase } || buffer == c.cleaned),
+                std::string("validateInPlace: ") + c.label);
+        }
+    }
+
+    // Saved FM-index round trip; an index of another sequence is refused
+    std::cout << "\n=== FM-index save / load ===" << std::endl;
+    {
+        std::string genome = randomBases(30000, 21);
+        std::string indexPath = "test_motif_search.fmi";
+
+        SequenceAnalyzer scanned;
+        scanned.setSequence(genome);
+        auto expected = spans(scanned.exactMatch("GATTACA"));
+
+        SequenceAnalyzer saver;
+        saver.setSequence(genome);
+        check(saver.saveIndex(indexPath), "saveIndex writes the index");
+
+        AnalysisOptions indexed;
+        indexed.useIndex = true;
+        SequenceAnalyzer loader;
+        loader.setOptions(indexed);
+        loader.setSequence(genome);
+        std::string error;
+        check(loader.loadIndex(indexPath, error) && loader.hasIndex(), "loadIndex accepts the same sequence");
+        check(spans(loader.exactMatch("GATTACA")) == expected, "indexed hits match KMP (" + std::to_string(expected.size()) + ")");
+
+        auto viaIndex = loader.exactMatch("GATTACA");
+        auto viaKMP = scanned.exactMatch("GATTACA");
+        check(!viaIndex.empty() && viaIndex[0].algorithm == "FM-index" && viaKMP[0].algorithm == "KMP",
+            "results name the algorithm that found them");
+        check(loader.exactMatchCompact("GATTACA").hits[0].algorithm == MatchAlgorithm::FM_INDEX,
+            "compact hits name the FM-index");
+        check(loader.getDFATracer()->getTraceSummary().find("Algorithm: FM-index") != std::string::npos,
+            "trace is labelled FM-index");
+
+        std::string mutated = genome;
+        mutated[15000] = mutated[15000] == 'A' ? 'C' : 'A';
+        SequenceAnalyzer other;
+        other.setSequence(mutated);
+        error.clear();
+        check(!other.loadIndex(indexPath, error) && !other.hasIndex() && !error.empty(),
+            "loadIndex rejects a sequence with another checksum");
+
+        std::ofstream(indexPath, std::ios::binary | std::ios::trunc) << "not an index";
+        check(!loader.loadIndex(indexPath, error), "loadIndex rejects a corrupt file");
+        std::remove(indexPath.c_str());
+    }
+
+    // The literal prefilter changes speed, not results
+    std::cout << "\n=== Regex prefilter ===" << std::endl;
+    {
+        std::string genome = randomBases(200000, 33);
+        genome.replace(1000, 30, "GGGCGGTTTTTTTTTTTTTTTTTTCCAATT");
+        genome.replace(90000, 12, "TATAAATATAAA");
+
+        for (const std::string& pattern : { std::string("GGGCGG.{0,40}CCAAT"), std::string("TATA[AT]A[AT]"),
+            std::string("(GAATTC|GGATCC)[ACGT]{2,6}A") }) {
+
+            RegexMatcher filtered;
+            filtered.compile(pattern);
+            RegexMatcher plain;
+            plain.setPrefilterEnabled(false);
+            plain.compile(pattern);
+
+            auto expected = regexSpans(plain, genome);
+            check(!expected.empty() && regexSpans(filtered, genome) == expected,
+                pattern + ": prefilter " + (filtered.usesPrefilter() ? "on" : "off") + " agrees ("
+                + std::to_string(expected.size()) + ")");
+        }
+    }
+
+    // A tiny DFA cache is flushed and refilled, with the same results
+    std::cout << "\n=== Regex DFA cache ===" << std::endl;
+    {
+        std::string genome = randomBases(200000, 33);
+        std::string unbounded = "A[CG]*T(A|C|GT)+G";
+        RegexMatcher roomy;
+        roomy.compile(unbounded);
+        RegexMatcher tiny;
+        tiny.setMaxCachedStates(4);
+        tiny.compile(unbounded);
+
+        auto expected = regexSpans(roomy, genome);
+        check(regexSpans(tiny, genome) == expected, "4-state DFA cache finds the same matches");
+        check(tiny.getCacheFlushes() > 0 && roomy.getCacheFlushes() == 0, "small cache flushes, default does not");
+    }
+
+    // Mapped records and .fai region fetches read the same bases
+    std::cout << "\n=== Mapped FASTA and .fai regions ===" << std::endl;
+    {
+        std::string chr1 = randomBases(1234, 41);
+        std::string chr2 = randomBases(500, 43);
+        std::string fastaPath = "test_motif_search.fa";
+        {
+            std::ofstream out(fastaPath, std::ios::binary);
+            out << ">chr1 first\n";
+            for (size_t i = 0; i < chr1.length(); i += 60) {
+                out << chr1.substr(i, 60) << "\n";
+            }
+            out << ">chr2\n" << chr2.substr(0, 100) << "\n" << chr2.substr(100, 7) << "\n" << chr2.substr(107) << "\n";
+        }
+
+        FASTAParser parser;
+        MappedFASTA mapped = parser.mapFile(fastaPath);
+        check(mapped.recordCount() == 2 && mapped.record(0).isUniform() && !mapped.record(1).isUniform(),
+            "records mapped, irregular lines detected");
+        check(mapped.sequence(0) == chr1 && mapped.sequence(1) == chr2, "sequence() joins every line");
+        check(mapped.extract(mapped.record(0), 55, 70) == chr1.substr(55, 70), "extract() across a line break");
+
+        std::string pieces;
+        mapped.forEachSpan(mapped.record(1), 95, 20, [&](std::string_view span) {
+            pieces.append(span.data(), span.size());
+            return true;
+        });
+        check(pieces == chr2.substr(95, 20), "forEachSpan() covers irregular lines");
+
+        FASTAIndex index = parser.indexFile(fastaPath, false);
+        check(index.size() == 1 && index.find("chr1") != nullptr && !index.getErrors().empty(),
+            "fai indexes the uniform record and reports the irregular one");
+
+        FASTARegionResult region = parser.fetchRegion(fastaPath, index, "chr1:50-1,000");
+        check(region.success && region.sequence == chr1.substr(49, 951), "fetchRegion chr1:50-1,000");
+
+        region = parser.fetchRegion(fastaPath, index, "chr1:1200-");
+        check(region.success && region.sequence == chr1.substr(1199), "fetchRegion clips open end");
+
+        region = parser.fetchRegion(fastaPath, index, "chrX:1-10");
+        check(!region.success && !region.errors.empty(), "fetchRegion rejects an unknown name");
+
+        mapped.close();
+        std::remove(fastaPath.c_str());
+    }
+
+    // Every supported PWM kernel reports the same hits as the scalar one
+    std::cout << "\n=== PWM kernels ===" << std::endl;
+    {
+        std::string genome = randomBases(100000, 51);
+        genome.replace(400, 10, "TATAAAAGGC");
+        genome.replace(50000, 3, "NNN");
+
+        std::vector<PositionWeightMatrix> matrices = {
+            PositionWeightMatrix::fromConsensus("M1", "TATA", "TATAWAWR"),
+            PositionWeightMatrix::fromConsensus("M2", "CAAT", "GGCCAATCT"),
+            PositionWeightMatrix::fromConsensus("M3", "Long", "GGGCGGRRCCAATSNNNNNNNNNNTATAWAWRNNNNNNNNNNNGGCGG"),
+        };
+
+        auto hitsWith = [&](CompositionKernel::Kernel kernel, bool lookahead) {
+            PWMScanner::Config config;
+            config.kernel = kernel;
+            config.lookahead = lookahead;
+            config.pValue = 1e-3;
+            PWMScanner scanner(config);
+            scanner.addMatrices(matrices);
+
+            std::vector<std::tuple<size_t, int, char, double>> hits;
+            for (const auto& hit : scanner.scan(genome)) {
+                hits.emplace_back(hit.position, hit.matrixId, hit.strand, hit.score);
+            }
+            return hits;
+        };
+
+        auto expected = hitsWith(CompositionKernel::Kernel::SCALAR, false);
+        check(!expected.empty(), "scalar kernel finds hits (" + std::to_string(expected.size()) + ")");
+        check(hitsWith(CompositionKernel::Kernel::SCALAR, true) == expected, "SCALAR with lookahead agrees");
+
+        for (auto kernel : { CompositionKernel::Kernel::SSE2, CompositionKernel::Kernel::AVX2 }) {
+            std::string name = CompositionKernel::kernelName(kernel);
+            if (!CompositionKernel::isSupported(kernel)) {
+                std::cout << "  SKIP: " << name << " not supported" << std::endl;
+                continue;
+            }
+            check(hitsWith(kernel, true) == expected, name + " agrees with SCALAR");
+        }
+    }
+
+    return checkSummary();
 }